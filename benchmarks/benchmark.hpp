@@ -0,0 +1,215 @@
+/**
+ * \file benchmark.hpp
+ *
+ * \brief A minimal, self-contained micro-benchmark harness
+ *
+ * Benchmarks are plain functions registered with #BENCHMARK_SUITE; each
+ * suite measures operations with bench::measure and reports them through
+ * a bench::table.
+ */
+
+#ifndef BENCHMARKS_BENCHMARK_HPP
+#define BENCHMARKS_BENCHMARK_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+  //--------------------------------------------------------------------------
+  // Optimization Barriers
+  //--------------------------------------------------------------------------
+
+  /// \brief Forces \p value to be materialized, so that the computation
+  ///        producing it cannot be discarded
+  ///
+  /// \param value the value to keep alive
+  template<typename T>
+  inline void do_not_optimize( const T& value )
+  {
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* s_sink;
+    s_sink = &value;
+#endif
+  }
+
+  /// \brief Forces all pending writes to memory to be considered observed
+  inline void clobber_memory()
+  {
+#if defined(__GNUC__)
+    asm volatile("" : : : "memory");
+#endif
+  }
+
+  //--------------------------------------------------------------------------
+  // Measurement
+  //--------------------------------------------------------------------------
+
+  /// \brief Measures the average time of a single call to \p fn
+  ///
+  /// \p fn is called in batches of increasing size until a batch takes long
+  /// enough to time reliably; the fastest of several such batches is
+  /// reported, to filter out preemption and frequency changes.
+  ///
+  /// \param fn the operation to measure
+  /// \param ops_per_call the number of operations performed by each call
+  /// \return the time of a single operation, in nanoseconds
+  template<typename Fn>
+  double measure( Fn&& fn, std::size_t ops_per_call = 1 )
+  {
+    using clock = std::chrono::steady_clock;
+
+    const auto min_batch_time = std::chrono::milliseconds(10);
+    const auto repetitions    = 5;
+
+    auto iterations = std::size_t(1);
+    auto best       = -1.0;
+
+    for(auto repetition = 0; repetition < repetitions; ) {
+      const auto start = clock::now();
+      for(auto i = std::size_t(0); i < iterations; ++i) {
+        fn();
+      }
+      const auto elapsed = clock::now() - start;
+
+      if(elapsed < min_batch_time) {
+        iterations *= 2;
+        continue;
+      }
+
+      const auto ns = std::chrono::duration<double,std::nano>(elapsed).count()
+                      / static_cast<double>(iterations * ops_per_call);
+      if(best < 0 || ns < best) {
+        best = ns;
+      }
+      ++repetition;
+    }
+    return best;
+  }
+
+  //--------------------------------------------------------------------------
+  // Reporting
+  //--------------------------------------------------------------------------
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// \brief A table of measurements, one row per operation and one column
+  ///        per implementation being compared
+  ////////////////////////////////////////////////////////////////////////////
+  class table
+  {
+  public:
+
+    /// \brief Starts a table with the given column headings
+    ///
+    /// \param title the title of the table
+    /// \param columns the names of the implementations being compared
+    table( std::string title, std::vector<std::string> columns )
+      : m_title(std::move(title)),
+        m_columns(std::move(columns))
+    {
+
+    }
+
+    /// \brief Adds a row of measurements, in nanoseconds per operation
+    ///
+    /// \param name the name of the operation
+    /// \param ns the measurement for each column
+    void add( std::string name, std::vector<double> ns )
+    {
+      m_rows.push_back( row{ std::move(name), std::move(ns) } );
+    }
+
+    /// \brief Prints the table to stdout
+    void print() const
+    {
+      std::printf( "\n%s (ns/op)\n", m_title.c_str() );
+      std::printf( "  %-24s", "" );
+      for(const auto& column : m_columns) {
+        std::printf( "%16s", column.c_str() );
+      }
+      std::printf( "\n" );
+
+      for(const auto& row : m_rows) {
+        std::printf( "  %-24s", row.name.c_str() );
+        for(auto ns : row.ns) {
+          std::printf( "%16.2f", ns );
+        }
+        std::printf( "\n" );
+      }
+    }
+
+  private:
+
+    struct row
+    {
+      std::string name;
+      std::vector<double> ns;
+    };
+
+    std::string m_title;
+    std::vector<std::string> m_columns;
+    std::vector<row> m_rows;
+  };
+
+  //--------------------------------------------------------------------------
+  // Registration
+  //--------------------------------------------------------------------------
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// \brief A named benchmark suite
+  ////////////////////////////////////////////////////////////////////////////
+  struct suite
+  {
+    const char* name;
+    void (*run)();
+  };
+
+  /// \brief Returns all suites registered with #BENCHMARK_SUITE
+  inline std::vector<suite>& suites()
+  {
+    static std::vector<suite> s_suites;
+    return s_suites;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// \brief Registers a suite during static initialization
+  ////////////////////////////////////////////////////////////////////////////
+  struct registrar
+  {
+    registrar( const char* name, void (*run)() )
+    {
+      suites().push_back( suite{ name, run } );
+    }
+  };
+
+  /// \brief Runs every registered suite whose name contains \p filter
+  ///
+  /// \param filter the substring to select suites by; empty for all
+  inline void run_suites( const char* filter )
+  {
+    for(const auto& suite : suites()) {
+      if(std::strstr(suite.name,filter) != nullptr) {
+        suite.run();
+      }
+    }
+  }
+
+} // namespace bench
+
+#define BENCHMARK_CONCAT_IMPL(a,b) a##b
+#define BENCHMARK_CONCAT(a,b) BENCHMARK_CONCAT_IMPL(a,b)
+
+/// \brief Defines and registers a benchmark suite named \p name
+#define BENCHMARK_SUITE(name) \
+  static void BENCHMARK_CONCAT(benchmark_suite_,__LINE__)(); \
+  static const ::bench::registrar BENCHMARK_CONCAT(benchmark_registrar_,__LINE__)( \
+    name, &BENCHMARK_CONCAT(benchmark_suite_,__LINE__) ); \
+  static void BENCHMARK_CONCAT(benchmark_suite_,__LINE__)()
+
+#endif /* BENCHMARKS_BENCHMARK_HPP */
@@ -0,0 +1,377 @@
+/**
+ * \file optional.bench.cpp
+ *
+ * \brief Benchmarks comparing #bpstd::optional against a bare \c T, and
+ *        against \c std::optional when built as C++17
+ */
+
+#include <bpstd/optional.hpp>
+
+#include "../benchmark.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201703L
+# include <optional>
+# define BENCHMARK_HAS_STD_OPTIONAL 1
+#endif
+
+namespace {
+
+  /// \brief A large trivially copyable type
+  struct pod256
+  {
+    unsigned char bytes[256];
+  };
+
+  //--------------------------------------------------------------------------
+  // Kinds
+  //--------------------------------------------------------------------------
+
+  /// \brief Presents a bare T through the interface of an optional, as a
+  ///        baseline for the cost of the value itself
+  template<typename T>
+  struct bare_kind
+  {
+    using value_type = T;
+    using type       = T;
+
+    static type make_empty() { return T(); }
+    static type make( const T& value ) { return value; }
+    static bool has_value( const type& ) { return true; }
+    static const T& get( const type& x ) { return x; }
+    static const T& value( const type& x ) { return x; }
+    static T value_or( const type& x, const T& ) { return x; }
+    static void emplace( type& x, const T& value ) { x = value; }
+    static void swap( type& a, type& b ) { using std::swap; swap(a,b); }
+    static bool less( const type&, const type& ) { return false; }
+  };
+
+  /// \brief Presents an optional class template through a common interface
+  template<template<typename> class Optional, typename T>
+  struct optional_kind
+  {
+    using value_type = T;
+    using type       = Optional<T>;
+
+    static type make_empty() { return type(); }
+    static type make( const T& value ) { return type(value); }
+    static bool has_value( const type& x ) { return static_cast<bool>(x); }
+    static const T& get( const type& x ) { return *x; }
+    static const T& value( const type& x ) { return x.value(); }
+    static T value_or( const type& x, const T& value ) { return x.value_or(value); }
+    static void emplace( type& x, const T& value ) { x.emplace(value); }
+    static void swap( type& a, type& b ) { a.swap(b); }
+
+    /// \brief Orders empty optionals before engaged ones
+    static bool less( const type& a, const type& b )
+    {
+      return !static_cast<bool>(a) && static_cast<bool>(b);
+    }
+  };
+
+  template<typename T>
+  using bpstd_kind = optional_kind<bpstd::optional,T>;
+
+#if BENCHMARK_HAS_STD_OPTIONAL
+  template<typename T>
+  using std_kind = optional_kind<std::optional,T>;
+#endif
+
+  //--------------------------------------------------------------------------
+  // Operations
+  //--------------------------------------------------------------------------
+
+  const auto vector_size = std::size_t(1024);
+
+  template<typename K>
+  struct construct_empty_op
+  {
+    static double run( const typename K::value_type& )
+    {
+      return bench::measure([]{
+        auto x = K::make_empty();
+        bench::do_not_optimize(x);
+      });
+    }
+  };
+
+  template<typename K>
+  struct construct_value_op
+  {
+    static double run( const typename K::value_type& value )
+    {
+      return bench::measure([&]{
+        auto x = K::make(value);
+        bench::do_not_optimize(x);
+      });
+    }
+  };
+
+  template<typename K>
+  struct copy_op
+  {
+    static double run( const typename K::value_type& value )
+    {
+      const auto source = K::make(value);
+      return bench::measure([&]{
+        auto x = source;
+        bench::do_not_optimize(x);
+      });
+    }
+  };
+
+  template<typename K>
+  struct move_op
+  {
+    static double run( const typename K::value_type& value )
+    {
+      auto source = K::make(value);
+      return bench::measure([&]{
+        auto x = std::move(source);
+        bench::do_not_optimize(x);
+        source = std::move(x);
+      });
+    }
+  };
+
+  template<typename K>
+  struct copy_assign_op
+  {
+    static double run( const typename K::value_type& value )
+    {
+      const auto source = K::make(value);
+      auto target = K::make(value);
+      return bench::measure([&]{
+        target = source;
+        bench::do_not_optimize(target);
+      });
+    }
+  };
+
+  template<typename K>
+  struct value_op
+  {
+    static double run( const typename K::value_type& value )
+    {
+      const auto source = K::make(value);
+      return bench::measure([&]{
+        bench::do_not_optimize( K::value(source) );
+      });
+    }
+  };
+
+  template<typename K>
+  struct value_or_engaged_op
+  {
+    static double run( const typename K::value_type& value )
+    {
+      const auto source   = K::make(value);
+      const auto fallback = typename K::value_type();
+      return bench::measure([&]{
+        bench::do_not_optimize( K::value_or(source,fallback) );
+      });
+    }
+  };
+
+  template<typename K>
+  struct value_or_empty_op
+  {
+    static double run( const typename K::value_type& value )
+    {
+      const auto source = K::make_empty();
+      return bench::measure([&]{
+        bench::do_not_optimize( K::value_or(source,value) );
+      });
+    }
+  };
+
+  template<typename K>
+  struct emplace_op
+  {
+    static double run( const typename K::value_type& value )
+    {
+      auto target = K::make(value);
+      return bench::measure([&]{
+        K::emplace(target,value);
+        bench::do_not_optimize(target);
+      });
+    }
+  };
+
+  template<typename K>
+  struct swap_op
+  {
+    static double run( const typename K::value_type& value )
+    {
+      auto a = K::make(value);
+      auto b = K::make(value);
+      return bench::measure([&]{
+        K::swap(a,b);
+        bench::clobber_memory();
+      });
+    }
+  };
+
+  template<typename K>
+  struct vector_growth_op
+  {
+    static double run( const typename K::value_type& value )
+    {
+      return bench::measure([&]{
+        auto values = std::vector<typename K::type>();
+        for(auto i = std::size_t(0); i < vector_size; ++i) {
+          values.push_back( K::make(value) );
+        }
+        bench::do_not_optimize(values.data());
+      }, vector_size);
+    }
+  };
+
+  template<typename K>
+  struct vector_iteration_op
+  {
+    static double run( const typename K::value_type& value )
+    {
+      // A third of the elements are empty, so that the branch on the engaged
+      // state is not trivially predictable
+      auto values = std::vector<typename K::type>();
+      for(auto i = std::size_t(0); i < vector_size; ++i) {
+        values.push_back( (i % 3 == 0) ? K::make_empty() : K::make(value) );
+      }
+      return bench::measure([&]{
+        for(const auto& x : values) {
+          if(K::has_value(x)) {
+            bench::do_not_optimize( K::get(x) );
+          }
+        }
+      }, vector_size);
+    }
+  };
+
+  /// \brief Makes a vector where about a third of the elements are empty,
+  ///        in an order that is not trivially predictable
+  template<typename K>
+  std::vector<typename K::type> make_mixed_vector( const typename K::value_type& value )
+  {
+    auto values = std::vector<typename K::type>();
+    auto state  = std::uint32_t(1);
+    for(auto i = std::size_t(0); i < vector_size; ++i) {
+      state = state * 1103515245u + 12345u;
+      values.push_back( ((state >> 16) % 3 == 0) ? K::make_empty() : K::make(value) );
+    }
+    return values;
+  }
+
+  template<typename K>
+  struct sort_op
+  {
+    static double run( const typename K::value_type& value )
+    {
+      // Each iteration restores the unsorted input, so this includes the
+      // cost of a vector copy-assignment
+      const auto input = make_mixed_vector<K>(value);
+      auto values = input;
+      return bench::measure([&]{
+        values = input;
+        std::sort( values.begin(), values.end(), &K::less );
+        bench::do_not_optimize(values.data());
+      }, vector_size);
+    }
+  };
+
+  template<typename K>
+  struct rotate_op
+  {
+    static double run( const typename K::value_type& value )
+    {
+      auto values = make_mixed_vector<K>(value);
+      return bench::measure([&]{
+        std::rotate( values.begin(), values.begin() + vector_size / 3, values.end() );
+        bench::do_not_optimize(values.data());
+      }, vector_size);
+    }
+  };
+
+  //--------------------------------------------------------------------------
+  // Suites
+  //--------------------------------------------------------------------------
+
+  /// \brief Measures \p Op for every kind and adds the results as a row
+  template<template<typename> class Op, typename T>
+  void add_row( bench::table& table, const char* name, const T& value )
+  {
+    table.add( name, {
+      Op<bare_kind<T>>::run(value),
+      Op<bpstd_kind<T>>::run(value),
+#if BENCHMARK_HAS_STD_OPTIONAL
+      Op<std_kind<T>>::run(value),
+#endif
+    });
+  }
+
+  template<typename T>
+  void run_suite( const char* type_name, const T& value )
+  {
+    auto table = bench::table( type_name, {
+      "T",
+      "bpstd::optional",
+#if BENCHMARK_HAS_STD_OPTIONAL
+      "std::optional",
+#endif
+    });
+
+    add_row<construct_empty_op>( table, "construct (empty)", value );
+    add_row<construct_value_op>( table, "construct (value)", value );
+    add_row<copy_op>( table, "copy", value );
+    add_row<move_op>( table, "move", value );
+    add_row<copy_assign_op>( table, "copy assign", value );
+    add_row<value_op>( table, "value", value );
+    add_row<value_or_engaged_op>( table, "value_or (engaged)", value );
+    add_row<value_or_empty_op>( table, "value_or (empty)", value );
+    add_row<emplace_op>( table, "emplace", value );
+    add_row<swap_op>( table, "swap", value );
+    add_row<vector_growth_op>( table, "vector growth", value );
+    add_row<vector_iteration_op>( table, "vector iteration", value );
+    add_row<sort_op>( table, "sort", value );
+    add_row<rotate_op>( table, "rotate", value );
+
+    table.print();
+  }
+
+  pod256 make_pod256()
+  {
+    auto result = pod256();
+    std::memset( result.bytes, 0xab, sizeof(result.bytes) );
+    return result;
+  }
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+BENCHMARK_SUITE("optional<int>")
+{
+  run_suite<int>( "int", 42 );
+}
+
+BENCHMARK_SUITE("optional<double>")
+{
+  run_suite<double>( "double", 3.14 );
+}
+
+BENCHMARK_SUITE("optional<std::string>")
+{
+  // Long enough to defeat the small-string optimization
+  run_suite<std::string>( "std::string", std::string(64,'x') );
+}
+
+BENCHMARK_SUITE("optional<pod256>")
+{
+  run_suite<pod256>( "pod256", make_pod256() );
+}
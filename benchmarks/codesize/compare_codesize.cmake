@@ -0,0 +1,77 @@
+# Compares the code size of the call_site_* functions of two objects: one
+# with bad_optional_access thrown inline at each call site, and one where
+# the throw is outlined into a shared cold helper.
+#
+# Usage: cmake -DNM=<nm> -DINLINE_OBJECT=<object file>
+#              -DOUTLINED_OBJECT=<object file> -P compare_codesize.cmake
+
+if(NOT NM OR NOT INLINE_OBJECT OR NOT OUTLINED_OBJECT)
+  message(FATAL_ERROR "NM, INLINE_OBJECT and OUTLINED_OBJECT must be defined")
+endif()
+
+# Sums the sizes of the text symbols of an object, split into the hot and
+# cold parts of the call sites, and the helpers that they share
+function(measure object prefix)
+  execute_process(
+    COMMAND "${NM}" -S -C --defined-only "${object}"
+    OUTPUT_VARIABLE symbols
+    RESULT_VARIABLE result
+  )
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Unable to read the symbols of '${object}'")
+  endif()
+
+  string(REPLACE ";" "\;" symbols "${symbols}")
+  string(REPLACE "\n" ";" lines "${symbols}")
+
+  set(sites 0)
+  set(hot 0)
+  set(cold 0)
+  set(shared 0)
+  foreach(line IN LISTS lines)
+    if(NOT line MATCHES "^[0-9a-f]+ ([0-9a-f]+) [tTW] (.*)$")
+      continue()
+    endif()
+    set(name "${CMAKE_MATCH_2}")
+    math(EXPR size "0x${CMAKE_MATCH_1}")
+    if(name MATCHES "call_site_.*\\[clone")
+      math(EXPR cold "${cold} + ${size}")
+    elseif(name MATCHES "call_site_")
+      math(EXPR sites "${sites} + 1")
+      math(EXPR hot "${hot} + ${size}")
+    else()
+      math(EXPR shared "${shared} + ${size}")
+    endif()
+  endforeach()
+
+  if(sites EQUAL 0)
+    message(FATAL_ERROR "No call sites found in '${object}'")
+  endif()
+
+  math(EXPR total "${hot} + ${cold} + ${shared}")
+  math(EXPR hot "${hot} / ${sites}")
+  math(EXPR cold "${cold} / ${sites}")
+  set(${prefix}_hot ${hot} PARENT_SCOPE)
+  set(${prefix}_cold ${cold} PARENT_SCOPE)
+  set(${prefix}_shared ${shared} PARENT_SCOPE)
+  set(${prefix}_total ${total} PARENT_SCOPE)
+  set(${prefix}_sites ${sites} PARENT_SCOPE)
+endfunction()
+
+measure("${INLINE_OBJECT}" inline)
+measure("${OUTLINED_OBJECT}" outlined)
+
+message("value() code size, in bytes (${outlined_sites} call sites)")
+message("                         hot/site  cold/site     shared      total")
+foreach(variant inline outlined)
+  set(row "  ${variant}                    ")
+  string(SUBSTRING "${row}" 0 25 row)
+  foreach(column hot cold shared total)
+    set(cell "          ${${variant}_${column}}")
+    string(LENGTH "${cell}" length)
+    math(EXPR start "${length} - 10")
+    string(SUBSTRING "${cell}" ${start} 10 cell)
+    set(row "${row}${cell} ")
+  endforeach()
+  message("${row}")
+endforeach()
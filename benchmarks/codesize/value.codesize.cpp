@@ -0,0 +1,49 @@
+/**
+ * \file value.codesize.cpp
+ *
+ * \brief Call sites of #bpstd::optional::value(), for comparing the code
+ *        size of each call site
+ *
+ * This translation unit is compiled twice and never linked: once as-is,
+ * and once with \c CODESIZE_INLINE_THROW defined, where every call site
+ * constructs and throws #bpstd::bad_optional_access inline instead of
+ * calling the shared cold helper used by \c value().
+ */
+
+#include <bpstd/optional.hpp>
+
+#include <string>
+
+namespace {
+
+  template<typename T>
+  inline const T& checked_value( const bpstd::optional<T>& optional )
+  {
+#if defined(CODESIZE_INLINE_THROW)
+    return optional ? *optional : throw bpstd::bad_optional_access();
+#else
+    return optional.value();
+#endif
+  }
+
+} // namespace
+
+#define CODESIZE_CALL_SITE(n) \
+  int call_site_##n( const bpstd::optional<int>& a, \
+                     const bpstd::optional<std::string>& b ) \
+  { \
+    return checked_value(a) * n + static_cast<int>(checked_value(b).size()); \
+  }
+
+namespace codesize {
+
+  CODESIZE_CALL_SITE(1)
+  CODESIZE_CALL_SITE(2)
+  CODESIZE_CALL_SITE(3)
+  CODESIZE_CALL_SITE(4)
+  CODESIZE_CALL_SITE(5)
+  CODESIZE_CALL_SITE(6)
+  CODESIZE_CALL_SITE(7)
+  CODESIZE_CALL_SITE(8)
+
+} // namespace codesize
@@ -0,0 +1,16 @@
+/**
+ * \file main.bench.cpp
+ *
+ * \brief Main benchmark to dispatch into the other benchmark suites.
+ *
+ * Usage: benchmarks [filter], where only the suites whose names contain
+ * \c filter are run.
+ */
+
+#include "benchmark.hpp"
+
+int main( int argc, char** argv )
+{
+  bench::run_suites( argc > 1 ? argv[1] : "" );
+  return 0;
+}
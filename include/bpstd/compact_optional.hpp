@@ -0,0 +1,434 @@
+/**
+ * \file compact_optional.hpp
+ *
+ * \brief This header provides #bpstd::compact_optional, an optional that
+ *        represents its empty state with a sentinel value of its type
+ */
+
+#ifndef BPSTD_COMPACT_OPTIONAL_HPP
+#define BPSTD_COMPACT_OPTIONAL_HPP
+
+#include "optional.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// BPSTD_DETAIL_COMPACT_OPTIONAL_NAN_BOXING is an internal switch, not a
+// configuration macro: it is set by this header and undefined at its end.
+// It provides the built-in traits for double and float, whose sentinels are
+// signaling NaNs. Targets that do their floating-point math on the x87
+// quiet a signaling NaN whenever it is loaded or returned, so the traits
+// are left undefined there.
+#if (defined(__i386__) && !defined(__SSE2_MATH__)) || \
+    (defined(_M_IX86) && (!defined(_M_IX86_FP) || _M_IX86_FP < 2))
+# define BPSTD_DETAIL_COMPACT_OPTIONAL_NAN_BOXING 0
+#else
+# define BPSTD_DETAIL_COMPACT_OPTIONAL_NAN_BOXING 1
+#endif
+
+namespace bpstd {
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// \class bpstd::compact_optional_traits
+  ///
+  /// \brief The customization point that declares the sentinel value used to
+  ///        represent the empty state of a compact_optional<T>.
+  ///
+  /// The primary template is intentionally left undefined; a type is made
+  /// usable with compact_optional by specializing this template (or by
+  /// passing a traits type explicitly). A conforming traits type provides:
+  ///
+  /// \code
+  /// // Returns the value stored in a disengaged compact_optional
+  /// static constexpr T empty_value() noexcept;
+  ///
+  /// // Returns whether value is the sentinel returned by empty_value()
+  /// static constexpr bool is_empty_value( const T& value ) noexcept;
+  /// \endcode
+  ///
+  /// A traits type may additionally provide the following, which
+  /// compact_optional::value_or uses in place of a compare and branch:
+  ///
+  /// \code
+  /// // Returns value, or default_value if value is the sentinel
+  /// static T select( T value, T default_value ) noexcept;
+  /// \endcode
+  ////////////////////////////////////////////////////////////////////////////
+  template<typename T>
+  struct compact_optional_traits;
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// \brief Built-in traits for pointers, using \c nullptr as the sentinel
+  ///
+  /// A compact_optional<T*> therefore cannot hold a null pointer as a
+  /// value; optional<T*> keeps a separate flag for pointers that may be
+  /// null.
+  ////////////////////////////////////////////////////////////////////////////
+  template<typename T>
+  struct compact_optional_traits<T*>
+  {
+    static constexpr T* empty_value() noexcept;
+    static constexpr bool is_empty_value( T* value ) noexcept;
+  };
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// \brief Built-in traits for std::unique_ptr with the default deleter,
+  ///        using a null pointer as the sentinel
+  ////////////////////////////////////////////////////////////////////////////
+  template<typename T>
+  struct compact_optional_traits<std::unique_ptr<T>>
+  {
+    static std::unique_ptr<T> empty_value() noexcept;
+    static bool is_empty_value( const std::unique_ptr<T>& value ) noexcept;
+  };
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// \brief Built-in traits for std::reference_wrapper
+  ///
+  /// A reference_wrapper can never be null, so the sentinel is a wrapper
+  /// bound to a private, never-constructed storage location that no real
+  /// object can share an address with. The sentinel is only ever compared
+  /// by address, never accessed.
+  ///
+  /// \note \c T must be a complete object type
+  ////////////////////////////////////////////////////////////////////////////
+  template<typename T>
+  struct compact_optional_traits<std::reference_wrapper<T>>
+  {
+    static std::reference_wrapper<T> empty_value() noexcept;
+    static bool is_empty_value( const std::reference_wrapper<T>& value ) noexcept;
+
+  private:
+
+    /// \brief Returns the storage location the sentinel is bound to
+    static T& sentinel() noexcept;
+  };
+
+#if BPSTD_DETAIL_COMPACT_OPTIONAL_NAN_BOXING
+  ////////////////////////////////////////////////////////////////////////////
+  /// \brief Built-in traits for double, reserving a single signaling NaN
+  ///        as the sentinel
+  ///
+  /// Arithmetic only ever produces quiet NaNs, so every NaN a computation
+  /// can yield -- including std::numeric_limits<double>::quiet_NaN() and
+  /// signaling_NaN() -- remains an ordinary engaged value. Only the exact
+  /// bit pattern of the sentinel is treated as empty, which makes
+  /// \c compact_optional<double> 8 bytes wide. \c value_or blends the bit
+  /// patterns of the value and the default with a mask, so it compiles into
+  /// an integer compare and select without a branch.
+  ///
+  /// \note These traits are not provided on targets whose floating-point
+  ///       math uses the x87, which quiets signaling NaNs; SSE and later
+  ///       never alter them.
+  ////////////////////////////////////////////////////////////////////////////
+  template<>
+  struct compact_optional_traits<double>
+  {
+    static_assert( std::numeric_limits<double>::is_iec559,
+                   "NaN-boxing requires IEEE-754 doubles" );
+
+    static double empty_value() noexcept;
+    static bool is_empty_value( double value ) noexcept;
+    static double select( double value, double default_value ) noexcept;
+
+  private:
+
+    static constexpr std::uint64_t sentinel_bits = 0x7ff0deadbeef0001ull;
+  };
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// \brief Built-in traits for float, reserving a single signaling NaN as
+  ///        the sentinel
+  ///
+  /// \see compact_optional_traits<double>
+  ////////////////////////////////////////////////////////////////////////////
+  template<>
+  struct compact_optional_traits<float>
+  {
+    static_assert( std::numeric_limits<float>::is_iec559,
+                   "NaN-boxing requires IEEE-754 floats" );
+
+    static float empty_value() noexcept;
+    static bool is_empty_value( float value ) noexcept;
+    static float select( float value, float default_value ) noexcept;
+
+  private:
+
+    static constexpr std::uint32_t sentinel_bits = 0x7f80beefu;
+  };
+#endif
+
+  namespace detail {
+
+    /// \brief Determines whether \p Traits provides a \c select function
+    ///        for values of type \p T
+    template<typename T, typename Traits, typename = void>
+    struct compact_optional_has_select : std::false_type{};
+
+    template<typename T, typename Traits>
+    struct compact_optional_has_select<T,Traits,
+      decltype(void(Traits::select(std::declval<T>(),std::declval<T>())))>
+      : std::true_type{};
+
+  } // namespace detail
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// \class bpstd::compact_optional
+  ///
+  /// \brief An optional that represents its empty state with a reserved
+  ///        sentinel value of \c T rather than with a separate flag.
+  ///
+  /// compact_optional offers the same interface as optional, but stores
+  /// nothing besides the value itself, so that
+  /// \c sizeof(compact_optional<T,Traits>) == \c sizeof(T). The sentinel is
+  /// described by \p Traits (see compact_optional_traits).
+  ///
+  /// Since the sentinel is a value of \c T, a compact_optional always holds
+  /// a live \c T; a disengaged compact_optional holds the sentinel. As a
+  /// consequence, engaging a compact_optional with a value equal to the
+  /// sentinel leaves it disengaged -- only use a compact_optional when the
+  /// sentinel can never be a meaningful value.
+  ///
+  /// The copy, move and destruction operations of compact_optional are
+  /// exactly those of \c T.
+  ///
+  /// \tparam T the type of the value
+  /// \tparam Traits the traits describing the sentinel value
+  ////////////////////////////////////////////////////////////////////////////
+  template<typename T, typename Traits = compact_optional_traits<T>>
+  class compact_optional final
+  {
+    //------------------------------------------------------------------------
+    // Public Member Types
+    //------------------------------------------------------------------------
+  public:
+
+    using value_type  = T;
+    using traits_type = Traits;
+
+    //------------------------------------------------------------------------
+    // Constructor / Destructor
+    //------------------------------------------------------------------------
+  public:
+
+    constexpr compact_optional();
+
+    constexpr compact_optional( nullopt_t );
+
+    compact_optional( const compact_optional& other ) = default;
+
+    compact_optional( compact_optional&& other ) = default;
+
+    constexpr compact_optional( const value_type& value );
+
+    constexpr compact_optional( value_type&& value );
+
+    template<typename...Args>
+    constexpr explicit compact_optional( in_place_t, Args&&... args );
+
+    template<typename U, typename...Args>
+    constexpr explicit compact_optional( in_place_t,
+                                         std::initializer_list<U> ilist,
+                                         Args&&...args );
+
+    ~compact_optional() = default;
+
+    //------------------------------------------------------------------------
+    // Assignment
+    //------------------------------------------------------------------------
+  public:
+
+    compact_optional& operator=( nullopt_t );
+    compact_optional& operator=( const compact_optional& other ) = default;
+    compact_optional& operator=( compact_optional&& other ) = default;
+    template<typename U, typename = typename std::enable_if<std::is_same<typename std::decay<U>::type, T>::value>::type>
+    compact_optional& operator=( U&& value );
+
+    //------------------------------------------------------------------------
+    // Observers
+    //------------------------------------------------------------------------
+  public:
+
+    /// \brief Accesses the contained value.
+    ///
+    /// If \c *this does not contain a value, this accesses the sentinel.
+    /// When \c BPSTD_OPTIONAL_HARDENED is enabled, this is checked and the
+    /// program is aborted instead.
+    ///
+    /// \return a pointer to the contained value
+    value_type* operator->() noexcept;
+
+    /// \copydoc operator->()
+    constexpr const value_type* operator->() const noexcept;
+
+    /// \brief Accesses the contained value.
+    ///
+    /// If \c *this does not contain a value, this accesses the sentinel.
+    /// When \c BPSTD_OPTIONAL_HARDENED is enabled, this is checked and the
+    /// program is aborted instead.
+    ///
+    /// \return a reference to the contained value
+    value_type& operator*() & noexcept;
+
+    /// \copydoc operator*() &
+    value_type&& operator*() && noexcept;
+
+    /// \copydoc operator*() &
+    constexpr const value_type& operator*() const& noexcept;
+
+    /// \copydoc operator*() &
+    constexpr const value_type&& operator*() const&& noexcept;
+
+    /// \brief Checks whether \c *this contains a value
+    ///
+    /// \return \c true if \c *this does not hold the sentinel value
+    constexpr explicit operator bool() const noexcept;
+
+    //------------------------------------------------------------------------
+
+    /// \brief Returns the contained value.
+    ///
+    /// \throws #bad_optional_access if \c *this does not contain a value.
+    ///
+    /// \return the value of \c *this
+    value_type& value() &;
+
+    /// \copydoc value() &
+    constexpr const value_type& value() const &;
+
+    /// \brief Returns the contained value.
+    ///
+    /// \throws #bad_optional_access if \c *this does not contain a value.
+    ///
+    /// \return the value of \c *this
+    value_type&& value() &&;
+
+    /// \copydoc value() &&
+    constexpr const value_type&& value() const &&;
+
+    /// \brief Returns the contained value, without any check.
+    ///
+    /// This is never checked, even when \c BPSTD_OPTIONAL_HARDENED is
+    /// enabled; it is intended for audited paths where \c *this is known to
+    /// contain a value. If it does not, this is the sentinel.
+    ///
+    /// \return the value of \c *this
+    value_type& unchecked_value() & noexcept;
+
+    /// \copydoc unchecked_value() &
+    value_type&& unchecked_value() && noexcept;
+
+    /// \copydoc unchecked_value() &
+    constexpr const value_type& unchecked_value() const & noexcept;
+
+    /// \copydoc unchecked_value() &
+    constexpr const value_type&& unchecked_value() const && noexcept;
+
+    //------------------------------------------------------------------------
+
+    /// \brief Returns the contained value if \c *this has a value,
+    ///        otherwise returns \p default_value.
+    ///
+    /// If \p Traits provides \c select, \p default_value is always
+    /// converted to \c T, and the result is chosen without a branch.
+    ///
+    /// \param default_value the value to use in case \c *this is empty
+    /// \return the value to use in case \c *this is empty
+    template<typename U>
+    constexpr value_type value_or( U&& default_value ) const &;
+
+    /// \copydoc value_or( U&& )
+    template<typename U>
+    value_type value_or( U&& default_value ) &&;
+
+    //------------------------------------------------------------------------
+    // Modifiers
+    //------------------------------------------------------------------------
+  public:
+
+    /// \brief Swaps the contents with those of other.
+    ///
+    /// \param other the compact_optional object to exchange the contents with
+    void swap( compact_optional& other )
+      noexcept(detail::is_nothrow_swappable<T>::value);
+
+    /// \brief Constructs the contained value in-place.
+    ///
+    /// The new value is constructed before it replaces the current one, so
+    /// that \c *this always holds a live \c T even if construction throws.
+    ///
+    /// \param args... the arguments to pass to the constructor
+    /// \return a reference to the new value
+    template<typename...Args>
+    value_type& emplace( Args&&...args );
+
+    /// \brief Constructs the contained value in-place.
+    ///
+    /// \param ilist   the initializer list to pass to the constructor
+    /// \param args... the arguments to pass to the constructor
+    /// \return a reference to the new value
+    template<typename U,typename...Args >
+    value_type& emplace( std::initializer_list<U> ilist, Args&&...args );
+
+    //------------------------------------------------------------------------
+    // Private Member Functions
+    //------------------------------------------------------------------------
+  private:
+
+    using has_select = detail::compact_optional_has_select<T,Traits>;
+
+    /// \brief Returns \p value, or \p default_value if \p value is the
+    ///        sentinel, chosen with Traits::select
+    ///
+    /// \param value the contained value
+    /// \param default_value the value to use in case \p value is the sentinel
+    /// \return the value to use
+    template<typename V, typename U>
+    static value_type select_value_or( std::true_type,
+                                       V&& value,
+                                       U&& default_value );
+
+    /// \brief Returns \p value, or \p default_value if \p value is the
+    ///        sentinel, chosen with a branch
+    ///
+    /// \param value the contained value
+    /// \param default_value the value to use in case \p value is the sentinel
+    /// \return the value to use
+    template<typename V, typename U>
+    static constexpr value_type select_value_or( std::false_type,
+                                                 V&& value,
+                                                 U&& default_value );
+
+    //------------------------------------------------------------------------
+    // Private Members
+    //------------------------------------------------------------------------
+  private:
+
+    value_type m_value; ///< The value, or the sentinel if disengaged
+  };
+
+  //--------------------------------------------------------------------------
+  // Utilities
+  //--------------------------------------------------------------------------
+
+  /// \brief Swaps the contents of \p lhs with those of \p rhs
+  ///
+  /// \param lhs the first compact_optional to swap
+  /// \param rhs the second compact_optional to swap
+  template<typename T, typename Traits>
+  void swap( compact_optional<T,Traits>& lhs, compact_optional<T,Traits>& rhs )
+    noexcept(noexcept(lhs.swap(rhs)));
+
+} // namespace bpstd
+
+#include "detail/compact_optional.inl"
+
+#undef BPSTD_DETAIL_COMPACT_OPTIONAL_NAN_BOXING
+
+#endif /* BPSTD_COMPACT_OPTIONAL_HPP */
@@ -0,0 +1,469 @@
+#ifndef DETAIL_COMPACT_OPTIONAL_INL
+#define DETAIL_COMPACT_OPTIONAL_INL
+
+namespace bpstd {
+
+  //--------------------------------------------------------------------------
+  // class : compact_optional_traits
+  //--------------------------------------------------------------------------
+
+  template<typename T>
+  inline constexpr T* compact_optional_traits<T*>::empty_value()
+    noexcept
+  {
+    return nullptr;
+  }
+
+  template<typename T>
+  inline constexpr bool compact_optional_traits<T*>::is_empty_value( T* value )
+    noexcept
+  {
+    return value == nullptr;
+  }
+
+  //--------------------------------------------------------------------------
+
+  template<typename T>
+  inline std::unique_ptr<T>
+    compact_optional_traits<std::unique_ptr<T>>::empty_value()
+    noexcept
+  {
+    return std::unique_ptr<T>();
+  }
+
+  template<typename T>
+  inline bool
+    compact_optional_traits<std::unique_ptr<T>>
+    ::is_empty_value( const std::unique_ptr<T>& value )
+    noexcept
+  {
+    return value == nullptr;
+  }
+
+  //--------------------------------------------------------------------------
+
+  template<typename T>
+  inline std::reference_wrapper<T>
+    compact_optional_traits<std::reference_wrapper<T>>::empty_value()
+    noexcept
+  {
+    return std::reference_wrapper<T>( sentinel() );
+  }
+
+  template<typename T>
+  inline bool
+    compact_optional_traits<std::reference_wrapper<T>>
+    ::is_empty_value( const std::reference_wrapper<T>& value )
+    noexcept
+  {
+    return std::addressof(value.get()) == std::addressof(sentinel());
+  }
+
+  template<typename T>
+  inline T& compact_optional_traits<std::reference_wrapper<T>>::sentinel()
+    noexcept
+  {
+    using storage_type = typename std::aligned_storage<sizeof(T),alignof(T)>::type;
+
+    static storage_type s_storage;
+
+    return *reinterpret_cast<T*>(&s_storage);
+  }
+
+#if BPSTD_DETAIL_COMPACT_OPTIONAL_NAN_BOXING
+  //--------------------------------------------------------------------------
+
+  inline double compact_optional_traits<double>::empty_value()
+    noexcept
+  {
+    const auto bits = sentinel_bits;
+    auto value = double();
+    std::memcpy( &value, &bits, sizeof(value) );
+    return value;
+  }
+
+  inline bool compact_optional_traits<double>::is_empty_value( double value )
+    noexcept
+  {
+    // NaNs never compare equal, so the sentinel is matched by its bits
+    auto bits = std::uint64_t();
+    std::memcpy( &bits, &value, sizeof(bits) );
+    return bits == sentinel_bits;
+  }
+
+  inline double compact_optional_traits<double>::select( double value,
+                                                         double default_value )
+    noexcept
+  {
+    auto value_bits = std::uint64_t();
+    auto default_bits = std::uint64_t();
+    std::memcpy( &value_bits, &value, sizeof(value_bits) );
+    std::memcpy( &default_bits, &default_value, sizeof(default_bits) );
+
+    // All ones if value is the sentinel, otherwise all zeros
+    const auto mask = std::uint64_t(0) - std::uint64_t(value_bits == sentinel_bits);
+    const auto bits = (value_bits & ~mask) | (default_bits & mask);
+
+    auto result = double();
+    std::memcpy( &result, &bits, sizeof(result) );
+    return result;
+  }
+
+  //--------------------------------------------------------------------------
+
+  inline float compact_optional_traits<float>::empty_value()
+    noexcept
+  {
+    const auto bits = sentinel_bits;
+    auto value = float();
+    std::memcpy( &value, &bits, sizeof(value) );
+    return value;
+  }
+
+  inline bool compact_optional_traits<float>::is_empty_value( float value )
+    noexcept
+  {
+    auto bits = std::uint32_t();
+    std::memcpy( &bits, &value, sizeof(bits) );
+    return bits == sentinel_bits;
+  }
+
+  inline float compact_optional_traits<float>::select( float value,
+                                                       float default_value )
+    noexcept
+  {
+    auto value_bits = std::uint32_t();
+    auto default_bits = std::uint32_t();
+    std::memcpy( &value_bits, &value, sizeof(value_bits) );
+    std::memcpy( &default_bits, &default_value, sizeof(default_bits) );
+
+    const auto mask = std::uint32_t(0) - std::uint32_t(value_bits == sentinel_bits);
+    const auto bits = (value_bits & ~mask) | (default_bits & mask);
+
+    auto result = float();
+    std::memcpy( &result, &bits, sizeof(result) );
+    return result;
+  }
+#endif
+
+  //--------------------------------------------------------------------------
+  // Constructor / Destructor
+  //--------------------------------------------------------------------------
+
+  template<typename T, typename Traits>
+  inline constexpr compact_optional<T,Traits>::compact_optional()
+    : m_value( Traits::empty_value() )
+  {
+
+  }
+
+  template<typename T, typename Traits>
+  inline constexpr compact_optional<T,Traits>::compact_optional( nullopt_t )
+    : compact_optional()
+  {
+
+  }
+
+  //--------------------------------------------------------------------------
+
+  template<typename T, typename Traits>
+  inline constexpr compact_optional<T,Traits>
+    ::compact_optional( const value_type& value )
+    : m_value( value )
+  {
+
+  }
+
+  template<typename T, typename Traits>
+  inline constexpr compact_optional<T,Traits>
+    ::compact_optional( value_type&& value )
+    : m_value( static_cast<value_type&&>(value) )
+  {
+
+  }
+
+  //--------------------------------------------------------------------------
+
+  template<typename T, typename Traits>
+  template<typename...Args>
+  inline constexpr compact_optional<T,Traits>
+    ::compact_optional( in_place_t, Args&&... args )
+    : m_value( static_cast<Args&&>(args)... )
+  {
+
+  }
+
+  template<typename T, typename Traits>
+  template<typename U, typename...Args>
+  inline constexpr compact_optional<T,Traits>
+    ::compact_optional( in_place_t,
+                        std::initializer_list<U> ilist,
+                        Args&&... args )
+    : m_value( ilist, static_cast<Args&&>(args)... )
+  {
+
+  }
+
+  //--------------------------------------------------------------------------
+  // Assignment
+  //--------------------------------------------------------------------------
+
+  template<typename T, typename Traits>
+  inline compact_optional<T,Traits>&
+    compact_optional<T,Traits>::operator=( nullopt_t )
+  {
+    m_value = Traits::empty_value();
+    return (*this);
+  }
+
+  template<typename T, typename Traits>
+  template<typename U, typename>
+  inline compact_optional<T,Traits>&
+    compact_optional<T,Traits>::operator=( U&& value )
+  {
+    m_value = std::forward<U>(value);
+    return (*this);
+  }
+
+  //--------------------------------------------------------------------------
+  // Observers
+  //--------------------------------------------------------------------------
+
+  template<typename T, typename Traits>
+  inline constexpr compact_optional<T,Traits>::operator bool()
+    const noexcept
+  {
+    return !Traits::is_empty_value(m_value);
+  }
+
+  //--------------------------------------------------------------------------
+
+  template<typename T, typename Traits>
+  inline typename compact_optional<T,Traits>::value_type*
+    compact_optional<T,Traits>::operator->()
+    noexcept
+  {
+    return detail::optional_check_engaged<T>(bool(*this)), &m_value;
+  }
+
+  template<typename T, typename Traits>
+  inline constexpr const typename compact_optional<T,Traits>::value_type*
+    compact_optional<T,Traits>::operator->()
+    const noexcept
+  {
+    return detail::optional_check_engaged<T>(bool(*this)), &m_value;
+  }
+
+  //--------------------------------------------------------------------------
+
+  template<typename T, typename Traits>
+  inline typename compact_optional<T,Traits>::value_type&
+    compact_optional<T,Traits>::operator*()
+    & noexcept
+  {
+    return detail::optional_check_engaged<T>(bool(*this)), m_value;
+  }
+
+  template<typename T, typename Traits>
+  inline typename compact_optional<T,Traits>::value_type&&
+    compact_optional<T,Traits>::operator*()
+    && noexcept
+  {
+    return detail::optional_check_engaged<T>(bool(*this)), std::move(m_value);
+  }
+
+  //--------------------------------------------------------------------------
+
+  template<typename T, typename Traits>
+  inline constexpr const typename compact_optional<T,Traits>::value_type&
+    compact_optional<T,Traits>::operator*()
+    const & noexcept
+  {
+    return detail::optional_check_engaged<T>(bool(*this)), m_value;
+  }
+
+  template<typename T, typename Traits>
+  inline constexpr const typename compact_optional<T,Traits>::value_type&&
+    compact_optional<T,Traits>::operator*()
+    const && noexcept
+  {
+    return detail::optional_check_engaged<T>(bool(*this)),
+           static_cast<const value_type&&>(m_value);
+  }
+
+  //--------------------------------------------------------------------------
+
+  template<typename T, typename Traits>
+  inline typename compact_optional<T,Traits>::value_type&
+    compact_optional<T,Traits>::value()
+    &
+  {
+    return BPSTD_OPTIONAL_LIKELY(bool(*this))
+      ? m_value
+      : (detail::throw_bad_optional_access<T>(), m_value);
+  }
+
+  template<typename T, typename Traits>
+  inline constexpr const typename compact_optional<T,Traits>::value_type&
+    compact_optional<T,Traits>::value()
+    const &
+  {
+    return BPSTD_OPTIONAL_LIKELY(bool(*this))
+      ? m_value
+      : (detail::throw_bad_optional_access<T>(), m_value);
+  }
+
+  //--------------------------------------------------------------------------
+
+  template<typename T, typename Traits>
+  inline typename compact_optional<T,Traits>::value_type&&
+    compact_optional<T,Traits>::value()
+    &&
+  {
+    return BPSTD_OPTIONAL_LIKELY(bool(*this))
+      ? std::move(m_value)
+      : (detail::throw_bad_optional_access<T>(), std::move(m_value));
+  }
+
+  template<typename T, typename Traits>
+  inline constexpr const typename compact_optional<T,Traits>::value_type&&
+    compact_optional<T,Traits>::value()
+    const &&
+  {
+    return BPSTD_OPTIONAL_LIKELY(bool(*this))
+      ? static_cast<const value_type&&>(m_value)
+      : (detail::throw_bad_optional_access<T>(), static_cast<const value_type&&>(m_value));
+  }
+
+  //--------------------------------------------------------------------------
+
+  template<typename T, typename Traits>
+  inline typename compact_optional<T,Traits>::value_type&
+    compact_optional<T,Traits>::unchecked_value()
+    & noexcept
+  {
+    return m_value;
+  }
+
+  template<typename T, typename Traits>
+  inline typename compact_optional<T,Traits>::value_type&&
+    compact_optional<T,Traits>::unchecked_value()
+    && noexcept
+  {
+    return std::move(m_value);
+  }
+
+  template<typename T, typename Traits>
+  inline constexpr const typename compact_optional<T,Traits>::value_type&
+    compact_optional<T,Traits>::unchecked_value()
+    const & noexcept
+  {
+    return m_value;
+  }
+
+  template<typename T, typename Traits>
+  inline constexpr const typename compact_optional<T,Traits>::value_type&&
+    compact_optional<T,Traits>::unchecked_value()
+    const && noexcept
+  {
+    return static_cast<const value_type&&>(m_value);
+  }
+
+  //--------------------------------------------------------------------------
+
+  template<typename T, typename Traits>
+  template<typename U>
+  inline constexpr typename compact_optional<T,Traits>::value_type
+    compact_optional<T,Traits>::value_or( U&& default_value )
+    const&
+  {
+    return select_value_or( has_select{}, m_value, static_cast<U&&>(default_value) );
+  }
+
+  template<typename T, typename Traits>
+  template<typename U>
+  inline typename compact_optional<T,Traits>::value_type
+    compact_optional<T,Traits>::value_or( U&& default_value )
+    &&
+  {
+    return select_value_or( has_select{}, std::move(m_value), std::forward<U>(default_value) );
+  }
+
+  //--------------------------------------------------------------------------
+  // Modifiers
+  //--------------------------------------------------------------------------
+
+  template<typename T, typename Traits>
+  inline void compact_optional<T,Traits>::swap( compact_optional& other )
+    noexcept(detail::is_nothrow_swappable<T>::value)
+  {
+    using std::swap;
+
+    // The sentinel is an ordinary value, so swapping the values also
+    // swaps the engaged states
+    swap(m_value,other.m_value);
+  }
+
+  //--------------------------------------------------------------------------
+
+  template<typename T, typename Traits>
+  template<typename...Args>
+  inline typename compact_optional<T,Traits>::value_type&
+    compact_optional<T,Traits>::emplace( Args&&...args )
+  {
+    m_value = value_type( std::forward<Args>(args)... );
+    return m_value;
+  }
+
+  template<typename T, typename Traits>
+  template<typename U, typename...Args>
+  inline typename compact_optional<T,Traits>::value_type&
+    compact_optional<T,Traits>::emplace( std::initializer_list<U> ilist,
+                                         Args&&...args )
+  {
+    m_value = value_type( ilist, std::forward<Args>(args)... );
+    return m_value;
+  }
+
+  //--------------------------------------------------------------------------
+  // Private Member Functions
+  //--------------------------------------------------------------------------
+
+  template<typename T, typename Traits>
+  template<typename V, typename U>
+  inline typename compact_optional<T,Traits>::value_type
+    compact_optional<T,Traits>::select_value_or( std::true_type,
+                                                 V&& value,
+                                                 U&& default_value )
+  {
+    return Traits::select( std::forward<V>(value),
+                           static_cast<value_type>(std::forward<U>(default_value)) );
+  }
+
+  template<typename T, typename Traits>
+  template<typename V, typename U>
+  inline constexpr typename compact_optional<T,Traits>::value_type
+    compact_optional<T,Traits>::select_value_or( std::false_type,
+                                                 V&& value,
+                                                 U&& default_value )
+  {
+    return Traits::is_empty_value(value)
+      ? static_cast<value_type>(static_cast<U&&>(default_value))
+      : static_cast<V&&>(value);
+  }
+
+  //--------------------------------------------------------------------------
+  // Utilities
+  //--------------------------------------------------------------------------
+
+  template<typename T, typename Traits>
+  inline void swap( compact_optional<T,Traits>& lhs,
+                    compact_optional<T,Traits>& rhs )
+    noexcept(noexcept(lhs.swap(rhs)))
+  {
+    lhs.swap(rhs);
+  }
+
+} // namespace bpstd
+
+#endif /* DETAIL_COMPACT_OPTIONAL_INL */
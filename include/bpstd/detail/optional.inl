@@ -3,320 +3,1485 @@
 
 namespace bpstd {
 
+  //--------------------------------------------------------------------------
+  // class : value_sentinel_traits
+  //--------------------------------------------------------------------------
+
+  template<typename T, T Sentinel>
+  inline constexpr T value_sentinel_traits<T,Sentinel>::empty_value()
+    noexcept
+  {
+    return Sentinel;
+  }
+
+  template<typename T, T Sentinel>
+  inline constexpr bool
+    value_sentinel_traits<T,Sentinel>::is_empty_value( const T& value )
+    noexcept
+  {
+    return value == Sentinel;
+  }
+
+  //--------------------------------------------------------------------------
+  // enum : compact_bool
+  //--------------------------------------------------------------------------
+
+  inline constexpr compact_bool to_compact_bool( bool value )
+    noexcept
+  {
+    return value ? compact_bool::true_value : compact_bool::false_value;
+  }
+
+  inline constexpr bool to_bool( compact_bool value )
+    noexcept
+  {
+    return value == compact_bool::true_value;
+  }
+
+  //--------------------------------------------------------------------------
+  // Bad Access Handler
+  //--------------------------------------------------------------------------
+
+  inline bad_optional_access_handler
+    set_bad_optional_access_handler( bad_optional_access_handler handler )
+    noexcept
+  {
+    return detail::optional_access_handler().exchange(handler);
+  }
+
+  inline bad_optional_access_handler get_bad_optional_access_handler()
+    noexcept
+  {
+    return detail::optional_access_handler().load();
+  }
+
+  //--------------------------------------------------------------------------
+  // Instrumentation
+  //--------------------------------------------------------------------------
+
+  template<typename T>
+  inline optional_counters optional_counters_snapshot()
+    noexcept
+  {
+    return detail::optional_thread_counters<T>();
+  }
+
+  template<typename T>
+  inline void reset_optional_counters()
+    noexcept
+  {
+    detail::optional_thread_counters<T>() = optional_counters();
+  }
+
+  namespace detail {
+
+    //------------------------------------------------------------------------
+    // Instrumentation
+    //------------------------------------------------------------------------
+
+    template<typename T>
+    inline optional_counters& optional_thread_counters()
+      noexcept
+    {
+      static thread_local optional_counters s_counters = optional_counters();
+
+      return s_counters;
+    }
+
+#if defined(BPSTD_OPTIONAL_INSTRUMENTATION)
+    template<typename T>
+    inline bool optional_count( std::size_t optional_counters::* counter )
+      noexcept
+    {
+      ++(optional_thread_counters<T>().*counter);
+      return true;
+    }
+#else
+    template<typename T>
+    inline constexpr bool optional_count( std::size_t optional_counters::* )
+      noexcept
+    {
+      return true;
+    }
+#endif
+
+    template<typename T, typename U>
+    inline constexpr std::size_t optional_counters::* optional_construct_counter()
+      noexcept
+    {
+      return !std::is_same<typename std::decay<U>::type,T>::value
+        ? &optional_counters::constructions
+        : std::is_lvalue_reference<U>::value
+          ? &optional_counters::copies
+          : &optional_counters::moves;
+    }
+
+    template<typename T>
+    [[noreturn]] BPSTD_OPTIONAL_COLD inline void optional_unchecked_access_failure()
+      noexcept
+    {
+      std::fputs( "bpstd::optional: access to an empty optional\n", stderr );
+      std::abort();
+    }
+
+#if BPSTD_OPTIONAL_HARDENED
+    template<typename T>
+    inline constexpr bool optional_check_engaged( bool engaged )
+      noexcept
+    {
+      return BPSTD_OPTIONAL_LIKELY(engaged)
+        ? true
+        : (optional_unchecked_access_failure<T>(), false);
+    }
+#else
+    template<typename T>
+    inline constexpr bool optional_check_engaged( bool )
+      noexcept
+    {
+      return true;
+    }
+#endif
+
+    inline std::atomic<bad_optional_access_handler>& optional_access_handler()
+      noexcept
+    {
+      static std::atomic<bad_optional_access_handler> s_handler(nullptr);
+      return s_handler;
+    }
+
+    template<typename T>
+    [[noreturn]] BPSTD_OPTIONAL_COLD inline void throw_bad_optional_access()
+    {
+      optional_count<T>(&optional_counters::bad_accesses);
+#if defined(BPSTD_OPTIONAL_NO_EXCEPTIONS)
+      const auto handler = get_bad_optional_access_handler();
+      if(handler != nullptr) {
+        handler();
+      }
+      std::abort();
+#else
+      throw bad_optional_access();
+#endif
+    }
+
+
+    //------------------------------------------------------------------------
+    // class : optional_destruct_base
+    //------------------------------------------------------------------------
+
+    template<typename T, bool B>
+    inline constexpr optional_destruct_base<T,B>::optional_destruct_base()
+      noexcept
+      : m_has_value(0),
+        m_empty()
+    {
+
+    }
+
+    template<typename T, bool B>
+    template<typename...Args>
+    inline constexpr optional_destruct_base<T,B>
+      ::optional_destruct_base( in_place_t, Args&&...args )
+      : m_has_value(1),
+        m_value( static_cast<Args&&>(args)... )
+    {
+
+    }
+
+    template<typename T, bool B>
+    inline constexpr optional_destruct_base<T,B>
+      ::optional_destruct_base( optional_niche_state state )
+      noexcept
+      : m_has_value(state.value),
+        m_empty()
+    {
+
+    }
+
+    //------------------------------------------------------------------------
+
+    template<typename T>
+    inline constexpr optional_destruct_base<T,false>::optional_destruct_base()
+      noexcept
+      : m_has_value(0),
+        m_empty()
+    {
+
+    }
+
+    template<typename T>
+    template<typename...Args>
+    inline constexpr optional_destruct_base<T,false>
+      ::optional_destruct_base( in_place_t, Args&&...args )
+      : m_has_value(1),
+        m_value( static_cast<Args&&>(args)... )
+    {
+
+    }
+
+    template<typename T>
+    inline constexpr optional_destruct_base<T,false>
+      ::optional_destruct_base( optional_niche_state state )
+      noexcept
+      : m_has_value(state.value),
+        m_empty()
+    {
+
+    }
+
+    template<typename T>
+    inline optional_destruct_base<T,false>::~optional_destruct_base()
+    {
+      if(has_value()) {
+        optional_count<T>(&optional_counters::destructions);
+        m_value.~T();
+      }
+    }
+
+    //------------------------------------------------------------------------
+
+    template<typename T, bool B>
+    inline T* optional_destruct_base<T,B>::val()
+      noexcept
+    {
+      return &m_value;
+    }
+
+    template<typename T, bool B>
+    inline constexpr const T* optional_destruct_base<T,B>::val()
+      const noexcept
+    {
+      return &m_value;
+    }
+
+    template<typename T>
+    inline T* optional_destruct_base<T,false>::val()
+      noexcept
+    {
+      return &m_value;
+    }
+
+    template<typename T>
+    inline constexpr const T* optional_destruct_base<T,false>::val()
+      const noexcept
+    {
+      return &m_value;
+    }
+
+    //------------------------------------------------------------------------
+
+    template<typename T, bool B>
+    inline constexpr bool optional_destruct_base<T,B>::has_value()
+      const noexcept
+    {
+      return m_has_value == 1;
+    }
+
+    template<typename T, bool B>
+    inline constexpr unsigned char optional_destruct_base<T,B>::niche_state()
+      const noexcept
+    {
+      return m_has_value;
+    }
+
+    template<typename T, bool B>
+    inline void optional_destruct_base<T,B>::mark_engaged()
+      noexcept
+    {
+      m_has_value = 1;
+    }
+
+    template<typename T, bool B>
+    inline void optional_destruct_base<T,B>::mark_disengaged()
+      noexcept
+    {
+      m_has_value = 0;
+    }
+
+    template<typename T>
+    inline constexpr bool optional_destruct_base<T,false>::has_value()
+      const noexcept
+    {
+      return m_has_value == 1;
+    }
+
+    template<typename T>
+    inline constexpr unsigned char optional_destruct_base<T,false>::niche_state()
+      const noexcept
+    {
+      return m_has_value;
+    }
+
+    template<typename T>
+    inline void optional_destruct_base<T,false>::mark_engaged()
+      noexcept
+    {
+      m_has_value = 1;
+    }
+
+    template<typename T>
+    inline void optional_destruct_base<T,false>::mark_disengaged()
+      noexcept
+    {
+      m_has_value = 0;
+    }
+
+    //------------------------------------------------------------------------
+    // class : optional_empty_storage
+    //------------------------------------------------------------------------
+
+    template<typename T>
+    inline constexpr optional_empty_storage<T>::optional_empty_storage()
+      noexcept
+      : T(),
+        m_has_value(0)
+    {
+
+    }
+
+    template<typename T>
+    template<typename...Args>
+    inline constexpr optional_empty_storage<T>
+      ::optional_empty_storage( in_place_t, Args&&...args )
+      : T( static_cast<Args&&>(args)... ),
+        m_has_value(1)
+    {
+
+    }
+
+    template<typename T>
+    inline constexpr optional_empty_storage<T>
+      ::optional_empty_storage( optional_niche_state state )
+      noexcept
+      : T(),
+        m_has_value(state.value)
+    {
+
+    }
+
+    //------------------------------------------------------------------------
+
+    template<typename T>
+    inline T* optional_empty_storage<T>::val()
+      noexcept
+    {
+      return static_cast<T*>(this);
+    }
+
+    template<typename T>
+    inline constexpr const T* optional_empty_storage<T>::val()
+      const noexcept
+    {
+      return static_cast<const T*>(this);
+    }
+
+    template<typename T>
+    inline constexpr bool optional_empty_storage<T>::has_value()
+      const noexcept
+    {
+      return m_has_value == 1;
+    }
+
+    template<typename T>
+    inline constexpr unsigned char optional_empty_storage<T>::niche_state()
+      const noexcept
+    {
+      return m_has_value;
+    }
+
+    template<typename T>
+    inline void optional_empty_storage<T>::mark_engaged()
+      noexcept
+    {
+      m_has_value = 1;
+    }
+
+    template<typename T>
+    inline void optional_empty_storage<T>::mark_disengaged()
+      noexcept
+    {
+      m_has_value = 0;
+    }
+
+    //------------------------------------------------------------------------
+    // class : optional_niche_storage
+    //------------------------------------------------------------------------
+
+    template<typename T>
+    inline constexpr optional_niche_storage<T>::optional_niche_storage()
+      noexcept
+      : m_value( optional_niche_state{empty_state} )
+    {
+
+    }
+
+    template<typename T>
+    template<typename...Args>
+    inline constexpr optional_niche_storage<T>
+      ::optional_niche_storage( in_place_t, Args&&...args )
+      : m_value( static_cast<Args&&>(args)... )
+    {
+
+    }
+
+    template<typename T>
+    inline constexpr optional_niche_storage<T>
+      ::optional_niche_storage( optional_niche_state state )
+      noexcept
+      : m_value( state )
+    {
+
+    }
+
+    //------------------------------------------------------------------------
+
+    template<typename T>
+    inline T* optional_niche_storage<T>::val()
+      noexcept
+    {
+      return &m_value;
+    }
+
+    template<typename T>
+    inline constexpr const T* optional_niche_storage<T>::val()
+      const noexcept
+    {
+      return &m_value;
+    }
+
+    template<typename T>
+    inline constexpr bool optional_niche_storage<T>::has_value()
+      const noexcept
+    {
+      return m_value.niche_state() < empty_state;
+    }
+
+    template<typename T>
+    inline constexpr unsigned char optional_niche_storage<T>::niche_state()
+      const noexcept
+    {
+      return m_value.niche_state();
+    }
+
+    template<typename T>
+    inline void optional_niche_storage<T>::mark_engaged()
+      noexcept
+    {
+      // Constructing the value already overwrote the empty state
+    }
+
+    template<typename T>
+    inline void optional_niche_storage<T>::mark_disengaged()
+      noexcept
+    {
+      // The inner optional holds nothing in either state, so it is simply
+      // re-created in the empty state
+      new (&m_value) T( optional_niche_state{empty_state} );
+    }
+
+    //------------------------------------------------------------------------
+    // class : optional_sentinel_storage
+    //------------------------------------------------------------------------
+
+    template<typename T>
+    inline constexpr optional_sentinel_storage<T>::optional_sentinel_storage()
+      noexcept
+      : m_value( traits_type::empty_value() )
+    {
+
+    }
+
+    template<typename T>
+    template<typename...Args>
+    inline constexpr optional_sentinel_storage<T>
+      ::optional_sentinel_storage( in_place_t, Args&&...args )
+      : m_value( static_cast<Args&&>(args)... )
+    {
+
+    }
+
+    //------------------------------------------------------------------------
+
+    template<typename T>
+    inline T* optional_sentinel_storage<T>::val()
+      noexcept
+    {
+      return &m_value;
+    }
+
+    template<typename T>
+    inline constexpr const T* optional_sentinel_storage<T>::val()
+      const noexcept
+    {
+      return &m_value;
+    }
+
+    template<typename T>
+    inline constexpr bool optional_sentinel_storage<T>::has_value()
+      const noexcept
+    {
+      return !traits_type::is_empty_value(m_value);
+    }
+
+    template<typename T>
+    inline void optional_sentinel_storage<T>::mark_engaged()
+      noexcept
+    {
+      // Constructing the value already overwrote the sentinel
+    }
+
+    template<typename T>
+    inline void optional_sentinel_storage<T>::mark_disengaged()
+      noexcept
+    {
+      m_value = traits_type::empty_value();
+    }
+
+    //------------------------------------------------------------------------
+    // class : optional_storage
+    //------------------------------------------------------------------------
+
+    template<typename T>
+    template<typename...Args>
+    inline void optional_storage<T>::construct( Args&&...args )
+    {
+      construct_value( is_niche(), std::forward<Args>(args)... );
+      this->mark_engaged();
+    }
+
+    template<typename T>
+    inline void optional_storage<T>::destruct()
+      noexcept
+    {
+      if(std::is_trivially_destructible<T>::value && !optional_instrumented) {
+        this->mark_disengaged();
+      } else if(has_value()) {
+        optional_count<T>(&optional_counters::destructions);
+        val()->~T();
+        this->mark_disengaged();
+      }
+    }
+
+    template<typename T>
+    inline void optional_storage<T>::destruct_engaged()
+      noexcept
+    {
+      optional_count<T>(&optional_counters::destructions);
+      val()->~T();
+      this->mark_disengaged();
+    }
+
+    //------------------------------------------------------------------------
+
+    template<typename T>
+    template<typename...Args>
+    inline void optional_storage<T>::construct_value( std::true_type,
+                                                      Args&&...args )
+    {
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+      try {
+        new (val()) T( std::forward<Args>(args)... );
+      } catch (...) {
+        this->mark_disengaged();
+        throw;
+      }
+#else
+      new (val()) T( std::forward<Args>(args)... );
+#endif
+    }
+
+    template<typename T>
+    template<typename...Args>
+    inline void optional_storage<T>::construct_value( std::false_type,
+                                                      Args&&...args )
+    {
+      new (val()) T( std::forward<Args>(args)... );
+    }
+
+    //------------------------------------------------------------------------
+    // class : optional_copy_ctor_base
+    //------------------------------------------------------------------------
+
+    template<typename T>
+    inline optional_copy_ctor_base<T,false,true>
+      ::optional_copy_ctor_base( const optional_copy_ctor_base& other )
+      noexcept(std::is_nothrow_copy_constructible<T>::value)
+      : optional_storage<T>()
+    {
+      if(other.has_value()) {
+        optional_count<T>(&optional_counters::copies);
+        this->construct( *other.val() );
+      }
+    }
+
+    //------------------------------------------------------------------------
+    // class : optional_move_ctor_base
+    //------------------------------------------------------------------------
+
+    template<typename T>
+    inline optional_move_ctor_base<T,false,true>
+      ::optional_move_ctor_base( optional_move_ctor_base&& other )
+      noexcept(std::is_nothrow_move_constructible<T>::value)
+      : optional_copy_ctor_base<T>()
+    {
+      if(other.has_value()) {
+        optional_count<T>(&optional_counters::moves);
+        this->construct( std::move(*other.val()) );
+      }
+    }
+
+    //------------------------------------------------------------------------
+    // class : optional_copy_assign_base
+    //------------------------------------------------------------------------
+
+    template<typename T>
+    inline optional_copy_assign_base<T,false,true>&
+      optional_copy_assign_base<T,false,true>
+      ::operator=( const optional_copy_assign_base& other )
+      noexcept(std::is_nothrow_copy_constructible<T>::value &&
+               std::is_nothrow_copy_assignable<T>::value)
+    {
+      if(this->has_value() && other.has_value()) {
+        optional_count<T>(&optional_counters::assignments);
+        *this->val() = *other.val();
+      } else if( this->has_value() ) {
+        this->destruct();
+      } else if( other.has_value() ) {
+        optional_count<T>(&optional_counters::copies);
+        this->construct( *other.val() );
+      }
+      return (*this);
+    }
+
+    //------------------------------------------------------------------------
+    // class : optional_move_assign_base
+    //------------------------------------------------------------------------
+
+    template<typename T>
+    inline optional_move_assign_base<T,false,true>&
+      optional_move_assign_base<T,false,true>
+      ::operator=( optional_move_assign_base&& other )
+      noexcept(std::is_nothrow_move_constructible<T>::value &&
+               std::is_nothrow_move_assignable<T>::value)
+    {
+      if(this->has_value() && other.has_value()) {
+        optional_count<T>(&optional_counters::assignments);
+        *this->val() = std::move(*other.val());
+      } else if( this->has_value() ) {
+        this->destruct();
+      } else if( other.has_value() ) {
+        optional_count<T>(&optional_counters::moves);
+        this->construct( std::move(*other.val()) );
+      }
+      return (*this);
+    }
+
+    //------------------------------------------------------------------------
+    // class : optional_direct_init
+    //------------------------------------------------------------------------
+
+    template<typename T>
+    template<typename...Args>
+    inline constexpr optional_direct_init<T>::optional_direct_init( Args&&...args )
+      : value( static_cast<Args&&>(args)... )
+    {
+
+    }
+
+  } // namespace detail
+
   //--------------------------------------------------------------------------
   // Constructor / Destructor
   //--------------------------------------------------------------------------
 
   template<typename T>
-  inline constexpr optional<T>::optional()
-    : m_has_value(false)
+  inline constexpr optional<T>::optional()
+    noexcept
+    : base_type()
+  {
+
+  }
+
+  template<typename T>
+  inline constexpr optional<T>::optional( nullopt_t )
+    noexcept
+    : optional()
+  {
+
+  }
+
+  //--------------------------------------------------------------------------
+
+  template<typename T>
+  inline constexpr optional<T>::optional( const value_type& value )
+    : base_type( (detail::optional_count<T>(&optional_counters::copies), in_place),
+                 value )
+  {
+
+  }
+
+
+  template<typename T>
+  inline constexpr optional<T>::optional( value_type&& value )
+    : base_type( (detail::optional_count<T>(&optional_counters::moves), in_place),
+                 static_cast<value_type&&>(value) )
+  {
+
+  }
+
+  //------------------------------------------------------------------------
+
+  template<typename T>
+  template<typename...Args>
+  inline constexpr optional<T>::optional( in_place_t,
+                                          Args&&... args )
+    : base_type( (detail::optional_count<T>(&optional_counters::constructions), in_place),
+                 static_cast<Args&&>(args)... )
+  {
+
+  }
+
+
+  template<typename T>
+  template<typename U, typename...Args>
+  inline constexpr optional<T>::optional( in_place_t,
+                                          std::initializer_list<U> ilist,
+                                          Args&&... args )
+    : base_type( (detail::optional_count<T>(&optional_counters::constructions), in_place),
+                 ilist, static_cast<Args&&>(args)... )
+  {
+
+  }
+
+  //------------------------------------------------------------------------
+
+  template<typename T>
+  template<typename U, detail::optional_converting_ctor_t<T,U,const U&,true>>
+  inline optional<T>::optional( const optional<U>& other )
+    : optional()
+  {
+    if(static_cast<bool>(other)) {
+      detail::optional_count<T>(&optional_counters::copies);
+      construct( *other );
+    }
+  }
+
+  template<typename T>
+  template<typename U, detail::optional_converting_ctor_t<T,U,const U&,false>>
+  inline optional<T>::optional( const optional<U>& other )
+    : optional()
+  {
+    if(static_cast<bool>(other)) {
+      detail::optional_count<T>(&optional_counters::copies);
+      construct( *other );
+    }
+  }
+
+
+  template<typename T>
+  template<typename U, detail::optional_converting_ctor_t<T,U,U&&,true>>
+  inline optional<T>::optional( optional<U>&& other )
+    : optional()
+  {
+    if(static_cast<bool>(other)) {
+      detail::optional_count<T>(&optional_counters::moves);
+      construct( *std::move(other) );
+    }
+  }
+
+  template<typename T>
+  template<typename U, detail::optional_converting_ctor_t<T,U,U&&,false>>
+  inline optional<T>::optional( optional<U>&& other )
+    : optional()
+  {
+    if(static_cast<bool>(other)) {
+      detail::optional_count<T>(&optional_counters::moves);
+      construct( *std::move(other) );
+    }
+  }
+
+  //--------------------------------------------------------------------------
+  // Assignment
+  //--------------------------------------------------------------------------
+
+  template<typename T>
+  inline optional<T>& optional<T>::operator=( nullopt_t )
+    noexcept
+  {
+    destruct();
+    return (*this);
+  }
+
+  template<typename T>
+  template<typename U, detail::optional_value_assign_t<T,U>>
+  inline optional<T>& optional<T>::operator=( U&& value )
+  {
+    if(has_value()) {
+      detail::optional_count<T>(&optional_counters::assignments);
+      *val() = std::forward<U>(value);
+    } else {
+      detail::optional_count<T>(detail::optional_construct_counter<T,U>());
+      construct( std::forward<U>(value) );
+    }
+    return (*this);
+  }
+
+  template<typename T>
+  template<typename U, detail::optional_converting_assign_t<T,U,const U&>>
+  inline optional<T>& optional<T>::operator=( const optional<U>& other )
+  {
+    if(!static_cast<bool>(other)) {
+      destruct();
+    } else if(has_value()) {
+      detail::optional_count<T>(&optional_counters::assignments);
+      *val() = *other;
+    } else {
+      detail::optional_count<T>(&optional_counters::copies);
+      construct( *other );
+    }
+    return (*this);
+  }
+
+  template<typename T>
+  template<typename U, detail::optional_converting_assign_t<T,U,U&&>>
+  inline optional<T>& optional<T>::operator=( optional<U>&& other )
+  {
+    if(!static_cast<bool>(other)) {
+      destruct();
+    } else if(has_value()) {
+      detail::optional_count<T>(&optional_counters::assignments);
+      *val() = *std::move(other);
+    } else {
+      detail::optional_count<T>(&optional_counters::moves);
+      construct( *std::move(other) );
+    }
+    return (*this);
+  }
+
+  //--------------------------------------------------------------------------
+  // Observers
+  //--------------------------------------------------------------------------
+
+  template<typename T>
+  inline constexpr optional<T>::operator bool()
+    const noexcept
+  {
+    return has_value();
+  }
+
+  //--------------------------------------------------------------------------
+
+  template<typename T>
+  inline typename optional<T>::value_type*
+    optional<T>::operator->()
+    noexcept
+  {
+    return detail::optional_check_engaged<T>(has_value()), val();
+  }
+
+  template<typename T>
+  inline constexpr const typename optional<T>::value_type*
+    optional<T>::operator->()
+    const noexcept
+  {
+    return detail::optional_check_engaged<T>(has_value()), val();
+  }
+
+  //--------------------------------------------------------------------------
+
+  template<typename T>
+  inline typename optional<T>::value_type&
+    optional<T>::operator*()
+    & noexcept
+  {
+    return detail::optional_check_engaged<T>(has_value()), *val();
+  }
+
+  template<typename T>
+  inline typename optional<T>::value_type&&
+    optional<T>::operator*()
+    && noexcept
+  {
+    return detail::optional_check_engaged<T>(has_value()), std::move(*val());
+  }
+
+  //--------------------------------------------------------------------------
+
+  template<typename T>
+  inline constexpr const typename optional<T>::value_type&
+    optional<T>::operator*()
+    const & noexcept
+  {
+    return detail::optional_check_engaged<T>(has_value()), *val();
+  }
+
+  template<typename T>
+  inline constexpr const typename optional<T>::value_type&&
+    optional<T>::operator*()
+    const && noexcept
+  {
+    return detail::optional_check_engaged<T>(has_value()),
+           static_cast<const value_type&&>(*val());
+  }
+
+  //--------------------------------------------------------------------------
+
+  template<typename T>
+  inline typename optional<T>::value_type&
+    optional<T>::value()
+    &
+  {
+    return BPSTD_OPTIONAL_LIKELY(has_value())
+      ? *val()
+      : (detail::throw_bad_optional_access<T>(), *val());
+  }
+
+  template<typename T>
+  inline constexpr const typename optional<T>::value_type&
+    optional<T>::value()
+    const &
+  {
+    return BPSTD_OPTIONAL_LIKELY(has_value())
+      ? *val()
+      : (detail::throw_bad_optional_access<T>(), *val());
+  }
+
+  //--------------------------------------------------------------------------
+
+  template<typename T>
+  inline typename optional<T>::value_type&&
+    optional<T>::value()
+    &&
+  {
+    return BPSTD_OPTIONAL_LIKELY(has_value())
+      ? std::move(*val())
+      : (detail::throw_bad_optional_access<T>(), std::move(*val()));
+  }
+
+  template<typename T>
+  inline constexpr const typename optional<T>::value_type&&
+    optional<T>::value()
+    const &&
+  {
+    return BPSTD_OPTIONAL_LIKELY(has_value())
+      ? static_cast<const value_type&&>(*val())
+      : (detail::throw_bad_optional_access<T>(), static_cast<const value_type&&>(*val()));
+  }
+
+  //--------------------------------------------------------------------------
+
+  template<typename T>
+  inline typename optional<T>::value_type&
+    optional<T>::unchecked_value()
+    & noexcept
   {
+    return *val();
+  }
 
+  template<typename T>
+  inline typename optional<T>::value_type&&
+    optional<T>::unchecked_value()
+    && noexcept
+  {
+    return std::move(*val());
   }
 
   template<typename T>
-  inline constexpr optional<T>::optional( nullopt_t )
-    : optional()
+  inline constexpr const typename optional<T>::value_type&
+    optional<T>::unchecked_value()
+    const & noexcept
   {
+    return *val();
+  }
 
+  template<typename T>
+  inline constexpr const typename optional<T>::value_type&&
+    optional<T>::unchecked_value()
+    const && noexcept
+  {
+    return static_cast<const value_type&&>(*val());
   }
 
   //--------------------------------------------------------------------------
 
   template<typename T>
-  inline optional<T>::optional( const optional& other )
-    : m_has_value(other.m_has_value)
+  template<typename U>
+  inline constexpr typename optional<T>::value_type
+    optional<T>::value_or( U&& default_value )
+    const&
   {
-    if(m_has_value)
-    {
-      new (val()) value_type( *other.val() );
-    }
+    return bool(*this)
+      ? (detail::optional_count<T>(&optional_counters::copies), *val())
+      : static_cast<value_type>(static_cast<U&&>(default_value));
   }
 
   template<typename T>
-  inline optional<T>::optional( optional&& other )
-    : m_has_value(other.m_has_value)
+  template<typename U>
+  inline typename optional<T>::value_type
+    optional<T>::value_or( U&& default_value )
+    &&
   {
-    if(m_has_value)
-    {
-      new (val()) value_type( std::move(*other.val()) );
-    }
+    return bool(*this)
+      ? (detail::optional_count<T>(&optional_counters::moves), std::move(*val()))
+      : static_cast<value_type>(std::forward<U>(default_value));
   }
 
   //--------------------------------------------------------------------------
 
   template<typename T>
-  inline optional<T>::optional( const value_type& value )
-    : m_has_value(true)
+  template<typename F>
+  inline constexpr typename optional<T>::value_type
+    optional<T>::value_or_else( F&& f )
+    const&
   {
-    new (val()) value_type(value);
+    return bool(*this)
+      ? (detail::optional_count<T>(&optional_counters::copies), *val())
+      : static_cast<value_type>(static_cast<F&&>(f)());
   }
 
-
   template<typename T>
-  inline optional<T>::optional( value_type&& value )
-    : m_has_value(true)
+  template<typename F>
+  inline typename optional<T>::value_type
+    optional<T>::value_or_else( F&& f )
+    &&
   {
-    new (val()) value_type(std::move(value));
+    return bool(*this)
+      ? (detail::optional_count<T>(&optional_counters::moves), std::move(*val()))
+      : static_cast<value_type>(std::forward<F>(f)());
   }
 
-  //------------------------------------------------------------------------
+  //--------------------------------------------------------------------------
 
   template<typename T>
-  template<typename...Args>
-  inline optional<T>::optional( in_place_t,
-                                Args&&... args )
-    : m_has_value(true)
+  template<typename...Args, detail::optional_construct_t<T,Args...>>
+  inline constexpr typename optional<T>::value_type
+    optional<T>::value_or_construct( Args&&...args )
+    const&
+  {
+    return bool(*this)
+      ? (detail::optional_count<T>(&optional_counters::copies), *val())
+      : detail::optional_direct_init<T>(static_cast<Args&&>(args)...).value;
+  }
+
+  template<typename T>
+  template<typename...Args, detail::optional_construct_t<T,Args...>>
+  inline typename optional<T>::value_type
+    optional<T>::value_or_construct( Args&&...args )
+    &&
   {
-    new (val()) value_type( std::forward<Args>(args)... );
+    return bool(*this)
+      ? (detail::optional_count<T>(&optional_counters::moves), std::move(*val()))
+      : detail::optional_direct_init<T>(std::forward<Args>(args)...).value;
   }
 
+  //--------------------------------------------------------------------------
+  // Monadic Operations
+  //--------------------------------------------------------------------------
 
   template<typename T>
-  template<typename U, typename...Args>
-  inline optional<T>::optional( in_place_t,
-                                std::initializer_list<U> ilist,
-                                Args&&... args )
-    : m_has_value(true)
+  template<typename F>
+  inline detail::optional_and_then_t<F,T&>
+    optional<T>::and_then( F&& f )
+    &
   {
-    new (val()) value_type( ilist, std::forward<Args>(args)... );
+    static_assert( detail::is_optional<detail::optional_and_then_t<F,value_type&>>::value,
+                   "and_then requires a function returning an optional" );
+
+    return bool(*this)
+      ? std::forward<F>(f)(*val())
+      : detail::optional_and_then_t<F,value_type&>();
+  }
+
+  template<typename T>
+  template<typename F>
+  inline constexpr detail::optional_and_then_t<F,const T&>
+    optional<T>::and_then( F&& f )
+    const &
+  {
+    static_assert( detail::is_optional<detail::optional_and_then_t<F,const value_type&>>::value,
+                   "and_then requires a function returning an optional" );
+
+    return bool(*this)
+      ? static_cast<F&&>(f)(*val())
+      : detail::optional_and_then_t<F,const value_type&>();
   }
 
   //--------------------------------------------------------------------------
 
   template<typename T>
-  inline optional<T>::~optional()
+  template<typename F>
+  inline detail::optional_and_then_t<F,T&&>
+    optional<T>::and_then( F&& f )
+    &&
+  {
+    static_assert( detail::is_optional<detail::optional_and_then_t<F,value_type&&>>::value,
+                   "and_then requires a function returning an optional" );
+
+    return bool(*this)
+      ? std::forward<F>(f)(std::move(*val()))
+      : detail::optional_and_then_t<F,value_type&&>();
+  }
+
+  template<typename T>
+  template<typename F>
+  inline constexpr detail::optional_and_then_t<F,const T&&>
+    optional<T>::and_then( F&& f )
+    const &&
   {
-    destruct();
+    static_assert( detail::is_optional<detail::optional_and_then_t<F,const value_type&&>>::value,
+                   "and_then requires a function returning an optional" );
+
+    return bool(*this)
+      ? static_cast<F&&>(f)(static_cast<const value_type&&>(*val()))
+      : detail::optional_and_then_t<F,const value_type&&>();
   }
 
   //--------------------------------------------------------------------------
-  // Assignment
+
+  template<typename T>
+  template<typename F>
+  inline detail::optional_transform_t<F,T&>
+    optional<T>::transform( F&& f )
+    &
+  {
+    return bool(*this)
+      ? detail::optional_transform_t<F,value_type&>( in_place, std::forward<F>(f)(*val()) )
+      : detail::optional_transform_t<F,value_type&>();
+  }
+
+  template<typename T>
+  template<typename F>
+  inline constexpr detail::optional_transform_t<F,const T&>
+    optional<T>::transform( F&& f )
+    const &
+  {
+    return bool(*this)
+      ? detail::optional_transform_t<F,const value_type&>( in_place, static_cast<F&&>(f)(*val()) )
+      : detail::optional_transform_t<F,const value_type&>();
+  }
+
   //--------------------------------------------------------------------------
 
   template<typename T>
-  inline optional<T>& optional<T>::operator=( nullopt_t )
+  template<typename F>
+  inline detail::optional_transform_t<F,T&&>
+    optional<T>::transform( F&& f )
+    &&
   {
-    destruct();
-    return (*this);
+    return bool(*this)
+      ? detail::optional_transform_t<F,value_type&&>( in_place, std::forward<F>(f)(std::move(*val())) )
+      : detail::optional_transform_t<F,value_type&&>();
   }
 
   template<typename T>
-  inline optional<T>& optional<T>::operator=( const optional& other )
+  template<typename F>
+  inline constexpr detail::optional_transform_t<F,const T&&>
+    optional<T>::transform( F&& f )
+    const &&
   {
-    if(m_has_value && other.m_has_value) {
-      *val() = *other.val();
-    } else if( m_has_value ) {
-      destruct();
-    } else if( other.m_has_value ) {
-      new (val()) value_type( *other.val() );
-      m_has_value = true;
-    }
-    return (*this);
+    return bool(*this)
+      ? detail::optional_transform_t<F,const value_type&&>( in_place, static_cast<F&&>(f)(static_cast<const value_type&&>(*val())) )
+      : detail::optional_transform_t<F,const value_type&&>();
   }
 
+  //--------------------------------------------------------------------------
+
   template<typename T>
-  inline optional<T>& optional<T>::operator=( optional&& other )
+  template<typename F>
+  inline constexpr optional<T> optional<T>::or_else( F&& f )
+    const &
   {
-    if(m_has_value && other.m_has_value) {
-      *val() = std::move( *other.val() );
-    } else if( m_has_value ) {
-      destruct();
-    } else if( other.m_has_value ) {
-      new (val()) value_type( std::move( *other.val() ) );
-      m_has_value = true;
-    }
-    return (*this);
+    static_assert( std::is_same<typename std::decay<detail::invoke_result_t<F>>::type,optional<T>>::value,
+                   "or_else requires a function returning an optional<T>" );
+
+    return bool(*this) ? *this : static_cast<optional>(static_cast<F&&>(f)());
   }
 
   template<typename T>
-  template<typename U, typename>
-  inline optional<T>& optional<T>::operator=( U&& value )
+  template<typename F>
+  inline optional<T> optional<T>::or_else( F&& f )
+    &&
   {
-    if(m_has_value) {
-      *val() = std::forward<U>(value);
-    } else {
-      new (val()) value_type( std::forward<U>(value) );
-      m_has_value = true;
-    }
-    return (*this);
+    static_assert( std::is_same<typename std::decay<detail::invoke_result_t<F>>::type,optional<T>>::value,
+                   "or_else requires a function returning an optional<T>" );
+
+    return bool(*this) ? std::move(*this) : static_cast<optional>(std::forward<F>(f)());
   }
 
   //--------------------------------------------------------------------------
-  // Observers
+  // Modifiers
   //--------------------------------------------------------------------------
 
   template<typename T>
-  inline constexpr optional<T>::operator bool()
-    const noexcept
+  inline void optional<T>::reset()
+    noexcept
   {
-    return m_has_value;
+    destruct();
   }
 
   //--------------------------------------------------------------------------
 
   template<typename T>
-  inline typename optional<T>::value_type*
-    optional<T>::operator->()
+  inline void optional<T>::swap( optional<T>& other )
+    noexcept(std::is_nothrow_move_constructible<T>::value &&
+             detail::is_nothrow_swappable<T>::value)
+  {
+    swap_impl( other, is_swapped_whole() );
+  }
+
+  template<typename T>
+  inline void optional<T>::swap_impl( optional<T>& other, std::true_type )
     noexcept
   {
-    return val();
+    // Small trivially copyable optionals are exchanged whole in registers,
+    // without branching on which side is engaged
+    const auto copy = *this;
+    *this = other;
+    other = copy;
   }
 
   template<typename T>
-  inline constexpr const typename optional<T>::value_type*
-    optional<T>::operator->()
-    const noexcept
+  inline void optional<T>::swap_impl( optional<T>& other, std::false_type )
+    noexcept(std::is_nothrow_move_constructible<T>::value &&
+             detail::is_nothrow_swappable<T>::value)
   {
-    return val();
+    using std::swap;
+
+    // When only one side is engaged, its value is moved across and then
+    // destroyed, leaving no moved-from value behind
+    if(has_value() && other.has_value()) {
+      swap(*val(),*other.val());
+    } else if(has_value()) {
+      detail::optional_count<T>(&optional_counters::moves);
+      other.construct( std::move(*val()) );
+      destruct_engaged();
+    } else if(other.has_value()) {
+      detail::optional_count<T>(&optional_counters::moves);
+      construct( std::move(*other.val()) );
+      other.destruct_engaged();
+    }
   }
 
   //--------------------------------------------------------------------------
 
   template<typename T>
+  template<typename...Args>
   inline typename optional<T>::value_type&
-    optional<T>::operator*()
-    & noexcept
+    optional<T>::emplace( Args&&...args )
+    noexcept(std::is_nothrow_constructible<T,Args...>::value)
   {
+    destruct();
+    detail::optional_count<T>(&optional_counters::constructions);
+    construct( std::forward<Args>(args)... );
     return *val();
   }
 
   template<typename T>
-  inline typename optional<T>::value_type&&
-    optional<T>::operator*()
-    && noexcept
+  template<typename U, typename...Args>
+  inline typename optional<T>::value_type&
+    optional<T>::emplace( std::initializer_list<U> ilist, Args&&...args )
+    noexcept(std::is_nothrow_constructible<T,std::initializer_list<U>&,Args...>::value)
   {
-    return std::move(*val());
+    destruct();
+    detail::optional_count<T>(&optional_counters::constructions);
+    construct( ilist, std::forward<Args>(args)... );
+    return *val();
   }
 
   //--------------------------------------------------------------------------
 
   template<typename T>
-  inline constexpr const typename optional<T>::value_type&
-    optional<T>::operator*()
-    const & noexcept
+  template<typename...Args>
+  inline typename optional<T>::value_type&
+    optional<T>::get_or_emplace( Args&&...args )
+    noexcept(std::is_nothrow_constructible<T,Args...>::value)
   {
+    if(!has_value()) {
+      detail::optional_count<T>(&optional_counters::constructions);
+      construct( std::forward<Args>(args)... );
+    }
     return *val();
   }
 
   template<typename T>
-  inline constexpr const typename optional<T>::value_type&&
-    optional<T>::operator*()
-    const && noexcept
+  template<typename F>
+  inline typename optional<T>::value_type&
+    optional<T>::get_or_emplace_with( F&& f )
   {
-    return std::move(*val());
+    if(!has_value()) {
+      detail::optional_count<T>(&optional_counters::constructions);
+      construct( std::forward<F>(f)() );
+    }
+    return *val();
   }
 
   //--------------------------------------------------------------------------
 
   template<typename T>
-  inline typename optional<T>::value_type&
-    optional<T>::value()
-    &
+  inline optional<T> optional<T>::take()
+    noexcept(std::is_nothrow_move_constructible<T>::value)
   {
-    return bool(*this) ? *val() : throw bad_optional_access();
+    // A single named result is returned on every path, so that it may be
+    // constructed in-place in the caller
+    auto result = optional<T>();
+
+    if(has_value()) {
+      detail::optional_count<T>(&optional_counters::moves);
+      result.construct( std::move(*val()) );
+      destruct_engaged();
+    }
+    return result;
   }
 
   template<typename T>
-  inline constexpr const typename optional<T>::value_type&
-    optional<T>::value()
-    const &
+  template<typename U>
+  inline optional<T> optional<T>::replace( U&& value )
+    noexcept(std::is_nothrow_move_constructible<T>::value &&
+             std::is_nothrow_constructible<T,U>::value)
   {
-    return bool(*this) ? *val() : throw bad_optional_access();
+    // The replacement is built before the previous value is taken, since
+    // 'value' may refer to the contained value
+    detail::optional_count<T>(detail::optional_construct_counter<T,U>());
+    T replacement( std::forward<U>(value) );
+
+    auto result = take();
+    construct( std::move(replacement) );
+    return result;
   }
 
+  //--------------------------------------------------------------------------
+  // Private Member Functions
   //--------------------------------------------------------------------------
 
   template<typename T>
-  inline typename optional<T>::value_type&&
-    optional<T>::value()
-    &&
+  inline constexpr optional<T>::optional( detail::optional_niche_state state )
+    noexcept
+    : base_type( state )
   {
-    return bool(*this) ? std::move(*val()) : throw bad_optional_access();
+
   }
 
   template<typename T>
-  inline constexpr const typename optional<T>::value_type&&
-    optional<T>::value()
-    const &&
+  inline constexpr unsigned char optional<T>::niche_state()
+    const noexcept
   {
-    return bool(*this) ? std::move(*val()) : throw bad_optional_access();
+    return base_type::niche_state();
   }
 
+  //--------------------------------------------------------------------------
+  // class : optional<T&>
   //--------------------------------------------------------------------------
 
   template<typename T>
-  template<typename U>
-  inline constexpr typename optional<T>::value_type
-    optional<T>::value_or( U&& default_value )
-    const&
+  inline constexpr optional<T&>::optional()
+    noexcept
+    : m_value(nullptr)
   {
-    return bool(*this) ? *val() : std::forward<U>(default_value);
+
   }
 
   template<typename T>
-  template<typename U>
-  inline typename optional<T>::value_type
-    optional<T>::value_or( U&& default_value )
-    &&
+  inline constexpr optional<T&>::optional( nullopt_t )
+    noexcept
+    : optional()
+  {
+
+  }
+
+  template<typename T>
+  inline constexpr optional<T&>::optional( T& value )
+    noexcept
+    : m_value(&value)
   {
-    return bool(*this) ? *val() : std::forward<U>(default_value);
+
   }
 
   //--------------------------------------------------------------------------
-  // Modifiers
+
+  template<typename T>
+  inline optional<T&>& optional<T&>::operator=( nullopt_t )
+    noexcept
+  {
+    m_value = nullptr;
+    return (*this);
+  }
+
   //--------------------------------------------------------------------------
 
   template<typename T>
-  inline void optional<T>::swap( optional<T>& other )
+  inline constexpr T* optional<T&>::operator->()
+    const noexcept
   {
-    using std::swap;
+    return detail::optional_check_engaged<T&>(m_value != nullptr), m_value;
+  }
 
-    if( m_has_value && other.m_has_value ){
-      swap(*val(),*other.val());
-    } else if( m_has_value ) {
-      other = std::move(*this);
-    } else if( other.m_has_value ) {
-      *this = std::move(other);
-    }
+  template<typename T>
+  inline constexpr T& optional<T&>::operator*()
+    const noexcept
+  {
+    return detail::optional_check_engaged<T&>(m_value != nullptr), *m_value;
+  }
+
+  template<typename T>
+  inline constexpr optional<T&>::operator bool()
+    const noexcept
+  {
+    return m_value != nullptr;
   }
 
   //--------------------------------------------------------------------------
 
   template<typename T>
-  template<typename...Args>
-  inline void optional<T>::emplace( Args&&...args )
+  inline constexpr T& optional<T&>::value()
+    const
   {
-    destruct();
-    new (val()) value_type( std::forward<Args>(args)... );
-    m_has_value = true;
+    return BPSTD_OPTIONAL_LIKELY(m_value != nullptr)
+      ? *m_value
+      : (detail::throw_bad_optional_access<T&>(), *m_value);
   }
 
   template<typename T>
-  template<typename U, typename...Args>
-  inline void optional<T>::emplace( std::initializer_list<U> ilist, Args&&...args )
+  inline constexpr T& optional<T&>::unchecked_value()
+    const noexcept
   {
-    // to do
+    return *m_value;
+  }
+
+  template<typename T>
+  inline constexpr T& optional<T&>::value_or( T& default_value )
+    const noexcept
+  {
+    return bool(*this) ? *m_value : default_value;
   }
 
-  //--------------------------------------------------------------------------
-  // Private Member Functions
   //--------------------------------------------------------------------------
 
   template<typename T>
-  inline constexpr T* optional<T>::val() const noexcept
+  inline void optional<T&>::swap( optional& other )
+    noexcept
   {
-    return reinterpret_cast<T*>( const_cast<storage_type*>(&m_value) );
+    using std::swap;
+
+    swap(m_value,other.m_value);
   }
 
   template<typename T>
-  inline void optional<T>::destruct()
-    const
+  inline T& optional<T&>::emplace( T& value )
+    noexcept
   {
-    if(!std::is_trivially_destructible<T>::value  && m_has_value) {
-      val()->~T();
-      m_has_value = false;
-    }
+    m_value = &value;
+    return value;
+  }
+
+  //--------------------------------------------------------------------------
+  // Utilities
+  //--------------------------------------------------------------------------
+
+  template<typename T>
+  inline void swap( optional<T>& lhs, optional<T>& rhs )
+    noexcept(noexcept(lhs.swap(rhs)))
+  {
+    lhs.swap(rhs);
   }
 
 } // namespace bpstd
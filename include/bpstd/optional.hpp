@@ -8,11 +8,52 @@
 #ifndef BPSTD_OPTIONAL_HPP
 #define BPSTD_OPTIONAL_HPP
 
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
 #include <initializer_list>
 #include <type_traits>
 #include <memory>
+#include <stdexcept>
 #include <utility>
 
+// BPSTD_OPTIONAL_NO_EXCEPTIONS selects the exception-free mode, where
+// accessing an empty optional calls the bad_optional_access handler rather
+// than throwing. It is defined automatically when exceptions are disabled,
+// and may be defined explicitly to select the mode regardless.
+#if !defined(BPSTD_OPTIONAL_NO_EXCEPTIONS) && \
+    !defined(__cpp_exceptions) && !defined(__EXCEPTIONS) && !defined(_CPPUNWIND)
+# define BPSTD_OPTIONAL_NO_EXCEPTIONS 1
+#endif
+
+// BPSTD_OPTIONAL_HARDENED checks that an optional is engaged when it is
+// accessed through operator* or operator->, aborting if it is not. It is
+// enabled unless NDEBUG is defined, and may be defined as 0 or 1 to
+// override this; unchecked_value() is never checked.
+#if !defined(BPSTD_OPTIONAL_HARDENED)
+# if defined(NDEBUG)
+#  define BPSTD_OPTIONAL_HARDENED 0
+# else
+#  define BPSTD_OPTIONAL_HARDENED 1
+# endif
+#endif
+
+// BPSTD_OPTIONAL_COLD marks a function as rarely called, so that it is
+// never inlined and is placed away from the hot code that calls it;
+// BPSTD_OPTIONAL_LIKELY hints that a condition is almost always true.
+// Both stay defined, since compact_optional.hpp relies on them as well.
+#if defined(__GNUC__) || defined(__clang__)
+# define BPSTD_OPTIONAL_COLD __attribute__((noinline,cold))
+# define BPSTD_OPTIONAL_LIKELY(x) __builtin_expect(!!(x),1)
+#elif defined(_MSC_VER)
+# define BPSTD_OPTIONAL_COLD __declspec(noinline)
+# define BPSTD_OPTIONAL_LIKELY(x) (x)
+#else
+# define BPSTD_OPTIONAL_COLD
+# define BPSTD_OPTIONAL_LIKELY(x) (x)
+#endif
+
 namespace bpstd {
 
   class bad_optional_access : public std::logic_error
@@ -22,6 +63,30 @@ namespace bpstd {
 
   };
 
+  /// \brief The handler called on accessing an empty optional when
+  ///        exceptions are disabled
+  ///
+  /// The handler must not return; if it does, the program is aborted.
+  using bad_optional_access_handler = void(*)();
+
+  /// \brief Installs the handler called on accessing an empty optional when
+  ///        exceptions are disabled
+  ///
+  /// The handler is only called in the exception-free mode selected by
+  /// \c BPSTD_OPTIONAL_NO_EXCEPTIONS; otherwise #bad_optional_access is
+  /// thrown. By default, the program is aborted.
+  ///
+  /// \param handler the new handler, or \c nullptr to abort
+  /// \return the previously installed handler
+  bad_optional_access_handler
+    set_bad_optional_access_handler( bad_optional_access_handler handler ) noexcept;
+
+  /// \brief Returns the handler called on accessing an empty optional when
+  ///        exceptions are disabled
+  ///
+  /// \return the installed handler, or \c nullptr if none is installed
+  bad_optional_access_handler get_bad_optional_access_handler() noexcept;
+
   struct nullopt_t{};
 
   struct in_place_t{};
@@ -29,6 +94,1000 @@ namespace bpstd {
   constexpr nullopt_t nullopt   = nullopt_t{};
   constexpr in_place_t in_place = in_place_t{};
 
+  ////////////////////////////////////////////////////////////////////////////
+  /// \class bpstd::value_sentinel_traits
+  ///
+  /// \brief A sentinel traits type that reserves the constant \p Sentinel
+  ///        as the empty state.
+  ///
+  /// This is suitable for integral, enumeration and pointer types, e.g.
+  /// \code
+  /// using index = compact_optional<std::size_t,
+  ///                                value_sentinel_traits<std::size_t,std::size_t(-1)>>;
+  /// \endcode
+  ///
+  /// \tparam T the type of the value
+  /// \tparam Sentinel the value that represents the empty state
+  ////////////////////////////////////////////////////////////////////////////
+  template<typename T, T Sentinel>
+  struct value_sentinel_traits
+  {
+    /// \brief Returns the value stored in a disengaged optional
+    ///
+    /// \return \p Sentinel
+    static constexpr T empty_value() noexcept;
+
+    /// \brief Checks whether \p value is the sentinel value
+    ///
+    /// \param value the value to check
+    /// \return \c true if \p value is \p Sentinel
+    static constexpr bool is_empty_value( const T& value ) noexcept;
+  };
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// \class bpstd::optional_sentinel_traits
+  ///
+  /// \brief The customization point through which an enumeration declares
+  ///        an out-of-range value that optional may use as its empty state.
+  ///
+  /// When specialized for an enumeration \c E, optional<E> stores no
+  /// engaged flag and is exactly \c sizeof(E). The specialization provides
+  /// the same members as value_sentinel_traits, and usually just derives
+  /// from it:
+  ///
+  /// \code
+  /// enum class color : std::uint8_t { red, green, blue };
+  ///
+  /// template<>
+  /// struct bpstd::optional_sentinel_traits<color>
+  ///   : bpstd::value_sentinel_traits<color,static_cast<color>(0xff)>{};
+  /// \endcode
+  ///
+  /// The sentinel must never be used as an actual value of the enumeration.
+  ////////////////////////////////////////////////////////////////////////////
+  template<typename T>
+  struct optional_sentinel_traits{};
+
+  template<typename T>
+  class optional;
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// \brief A boolean whose optional fits in a single byte
+  ///
+  /// optional<bool> keeps a separate flag byte, since a constant expression
+  /// could not observe an empty state stored in a spare representation of
+  /// \c bool. optional<compact_bool> declares a sentinel instead, so it
+  /// encodes empty, false and true in one byte, and checking it and reading
+  /// it are a single load.
+  ///
+  /// \see tribool
+  ////////////////////////////////////////////////////////////////////////////
+  enum class compact_bool : unsigned char
+  {
+    false_value = 0,
+    true_value  = 1,
+  };
+
+  template<>
+  struct optional_sentinel_traits<compact_bool>
+    : value_sentinel_traits<compact_bool,static_cast<compact_bool>(0xff)>{};
+
+  /// \brief A single-byte tri-state boolean: empty, false or true
+  using tribool = optional<compact_bool>;
+
+  /// \brief Converts \p value to a compact_bool
+  ///
+  /// \param value the boolean to convert
+  /// \return the compact_bool holding \p value
+  constexpr compact_bool to_compact_bool( bool value ) noexcept;
+
+  /// \brief Converts \p value to a bool
+  ///
+  /// \param value the compact_bool to convert
+  /// \return \c true if \p value is compact_bool::true_value
+  constexpr bool to_bool( compact_bool value ) noexcept;
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// \class bpstd::optional_counters
+  ///
+  /// \brief The operations performed by the optionals of a single type on a
+  ///        single thread
+  ///
+  /// Operations are only counted when \c BPSTD_OPTIONAL_INSTRUMENTATION is
+  /// defined before optional.hpp is included, in every translation unit of
+  /// the program. In that mode every optional uses the general, flagged
+  /// storage with non-trivial special members, so that each operation
+  /// passes through a counting path; instrumented optionals are therefore
+  /// neither trivially copyable nor usable in constant expressions.
+  ///
+  /// This is intended for finding hidden copies of large payloads in tests:
+  ///
+  /// \code
+  /// bpstd::reset_optional_counters<payload>();
+  /// run_pipeline();
+  /// REQUIRE( bpstd::optional_counters_snapshot<payload>().copies == 0 );
+  /// \endcode
+  ////////////////////////////////////////////////////////////////////////////
+  struct optional_counters
+  {
+    std::size_t constructions; ///< Values constructed from arguments
+    std::size_t copies;        ///< Values copied, into or out of an optional
+    std::size_t moves;         ///< Values moved, into or out of an optional
+    std::size_t assignments;   ///< Values assigned over an engaged value
+    std::size_t destructions;  ///< Values destroyed
+    std::size_t bad_accesses;  ///< Values accessed through value() while empty
+  };
+
+  /// \brief Returns the operations counted for optional<T> on this thread
+  ///
+  /// \return the counters; all zero unless instrumentation is enabled
+  template<typename T>
+  optional_counters optional_counters_snapshot() noexcept;
+
+  /// \brief Resets the operations counted for optional<T> on this thread
+  template<typename T>
+  void reset_optional_counters() noexcept;
+
+  namespace detail {
+
+#if defined(BPSTD_OPTIONAL_INSTRUMENTATION)
+    constexpr bool optional_instrumented = true;
+#else
+    constexpr bool optional_instrumented = false;
+#endif
+
+    /// \brief Returns the counters of optional<T> for the current thread
+    template<typename T>
+    optional_counters& optional_thread_counters() noexcept;
+
+    /// \brief Counts an operation of optional<T> if instrumentation is
+    ///        enabled
+    ///
+    /// This returns \c true so that it may be used within the
+    /// mem-initializers and single return statements of constexpr functions.
+    ///
+    /// \param counter the counter to increment
+    /// \return \c true
+#if defined(BPSTD_OPTIONAL_INSTRUMENTATION)
+    template<typename T>
+    bool optional_count( std::size_t optional_counters::* counter ) noexcept;
+#else
+    template<typename T>
+    constexpr bool optional_count( std::size_t optional_counters::* counter ) noexcept;
+#endif
+
+    /// \brief Gets the counter of constructing a \c T from a \c U
+    ///
+    /// A \c U that is \c T itself is counted as a copy if it is an lvalue
+    /// and as a move otherwise; any other \c U is counted as a
+    /// construction.
+    ///
+    /// \return the counter to increment
+    template<typename T, typename U>
+    constexpr std::size_t optional_counters::* optional_construct_counter() noexcept;
+
+    /// \brief Reports an access to an empty optional<T> through operator*
+    ///        or operator->, and aborts
+    template<typename T>
+    [[noreturn]] BPSTD_OPTIONAL_COLD void optional_unchecked_access_failure() noexcept;
+
+    /// \brief Checks that an optional being accessed is engaged, if
+    ///        \c BPSTD_OPTIONAL_HARDENED is enabled
+    ///
+    /// This returns \c true so that it may be used within the single
+    /// return statements of constexpr functions.
+    ///
+    /// \param engaged whether the optional<T> is engaged
+    /// \return \c true
+    template<typename T>
+    constexpr bool optional_check_engaged( bool engaged ) noexcept;
+
+    /// \brief Returns the installed bad_optional_access handler
+    std::atomic<bad_optional_access_handler>& optional_access_handler() noexcept;
+
+    /// \brief Counts and throws the exception for accessing an empty
+    ///        optional<T>
+    ///
+    /// This is kept out-of-line and cold, so that each call site of
+    /// \c value() only pays for a call rather than for constructing and
+    /// throwing the exception inline. In the exception-free mode, the
+    /// installed bad_optional_access handler is called instead.
+    ///
+    /// \throws #bad_optional_access always, unless exceptions are disabled
+    template<typename T>
+    [[noreturn]] BPSTD_OPTIONAL_COLD void throw_bad_optional_access();
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief The state byte that a disengaged optional is constructed with
+    ///        when it is the value of an enclosing optional that is empty
+    ///
+    /// The flag of an optional only ever holds \c 0 or \c 1, so each
+    /// enclosing optional marks itself empty with the next free value.
+    //////////////////////////////////////////////////////////////////////////
+    struct optional_niche_state
+    {
+      unsigned char value; ///< The state byte
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief The underlying storage of an optional value, along with the
+    ///        flag indicating whether or not it is engaged.
+    ///
+    /// The value is stored in a union so that optionals of literal types may
+    /// be constructed and inspected in constant expressions, and so that the
+    /// empty state is constant-initialized.
+    ///
+    /// The flag is the first member, so it is always the first byte of the
+    /// optional. All members live in this one class, so the optional is a
+    /// standard-layout type whenever \c T is.
+    ///
+    /// This type is trivially destructible when \c T is trivially
+    /// destructible, and otherwise destroys the value if one is present.
+    //////////////////////////////////////////////////////////////////////////
+    template<typename T, bool = !optional_instrumented &&
+                                std::is_trivially_destructible<T>::value>
+    class optional_destruct_base
+    {
+      //----------------------------------------------------------------------
+      // Constructor
+      //----------------------------------------------------------------------
+    protected:
+
+      constexpr optional_destruct_base() noexcept;
+
+      template<typename...Args>
+      constexpr explicit optional_destruct_base( in_place_t, Args&&...args );
+
+      /// \brief Constructs a disengaged storage whose flag holds \p state
+      ///
+      /// \param state the state byte of an enclosing, empty optional
+      constexpr explicit optional_destruct_base( optional_niche_state state ) noexcept;
+
+      //----------------------------------------------------------------------
+      // Protected Member Functions
+      //----------------------------------------------------------------------
+    protected:
+
+      /// \brief Gets a pointer to the value type
+      ///
+      /// \return the pointer
+      T* val() noexcept;
+
+      /// \copydoc val()
+      constexpr const T* val() const noexcept;
+
+      /// \brief Checks whether the optional contains a value
+      ///
+      /// \return \c true if the optional contains a value
+      constexpr bool has_value() const noexcept;
+
+      /// \brief Gets the state byte, which enclosing optionals share
+      ///
+      /// \return the state byte
+      constexpr unsigned char niche_state() const noexcept;
+
+      /// \brief Marks the optional as engaged, after a value is constructed
+      void mark_engaged() noexcept;
+
+      /// \brief Marks the optional as disengaged, after its value is destroyed
+      void mark_disengaged() noexcept;
+
+      //----------------------------------------------------------------------
+      // Protected Members
+      //----------------------------------------------------------------------
+    protected:
+
+      unsigned char m_has_value; ///< 1 if the optional has a value
+
+      union {
+        char m_empty;  ///< The active member when disengaged
+        T m_value;     ///< The value of this optional
+      };
+    };
+
+    template<typename T>
+    class optional_destruct_base<T,false>
+    {
+      //----------------------------------------------------------------------
+      // Constructor / Destructor
+      //----------------------------------------------------------------------
+    protected:
+
+      constexpr optional_destruct_base() noexcept;
+
+      template<typename...Args>
+      constexpr explicit optional_destruct_base( in_place_t, Args&&...args );
+
+      constexpr explicit optional_destruct_base( optional_niche_state state ) noexcept;
+
+      ~optional_destruct_base();
+
+      //----------------------------------------------------------------------
+      // Protected Member Functions
+      //----------------------------------------------------------------------
+    protected:
+
+      T* val() noexcept;
+      constexpr const T* val() const noexcept;
+
+      constexpr bool has_value() const noexcept;
+
+      constexpr unsigned char niche_state() const noexcept;
+
+      void mark_engaged() noexcept;
+
+      void mark_disengaged() noexcept;
+
+      //----------------------------------------------------------------------
+      // Protected Members
+      //----------------------------------------------------------------------
+    protected:
+
+      unsigned char m_has_value; ///< 1 if the optional has a value
+
+      union {
+        char m_empty;  ///< The active member when disengaged
+        T m_value;     ///< The value of this optional
+      };
+    };
+
+    namespace adl_swap {
+      using std::swap;
+
+      ////////////////////////////////////////////////////////////////////////
+      /// \brief Determines whether swapping two \c T lvalues, found through
+      ///        argument-dependent lookup or std::swap, does not throw
+      ////////////////////////////////////////////////////////////////////////
+      template<typename T>
+      struct is_nothrow_swappable
+        : std::integral_constant<bool,noexcept(swap(std::declval<T&>(),std::declval<T&>()))>{};
+    } // namespace adl_swap
+
+    using adl_swap::is_nothrow_swappable;
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief Determines whether \c T is a specialization of optional
+    //////////////////////////////////////////////////////////////////////////
+    template<typename T>
+    struct is_optional : std::false_type{};
+
+    template<typename T>
+    struct is_optional<optional<T>> : std::true_type{};
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief Determines whether \c T can be constructed or converted from
+    ///        an optional<U> of any value category
+    ///
+    /// Converting from optional<U> would be ambiguous with constructing
+    /// the value from the optional itself in that case.
+    //////////////////////////////////////////////////////////////////////////
+    template<typename T, typename U>
+    struct is_constructible_from_optional : std::integral_constant<bool,
+      std::is_constructible<T,optional<U>&>::value ||
+      std::is_constructible<T,const optional<U>&>::value ||
+      std::is_constructible<T,optional<U>&&>::value ||
+      std::is_constructible<T,const optional<U>&&>::value ||
+      std::is_convertible<optional<U>&,T>::value ||
+      std::is_convertible<const optional<U>&,T>::value ||
+      std::is_convertible<optional<U>&&,T>::value ||
+      std::is_convertible<const optional<U>&&,T>::value
+    >{};
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief Determines whether \c T can be assigned from an optional<U>
+    ///        of any value category
+    //////////////////////////////////////////////////////////////////////////
+    template<typename T, typename U>
+    struct is_assignable_from_optional : std::integral_constant<bool,
+      std::is_assignable<T&,optional<U>&>::value ||
+      std::is_assignable<T&,const optional<U>&>::value ||
+      std::is_assignable<T&,optional<U>&&>::value ||
+      std::is_assignable<T&,const optional<U>&&>::value
+    >{};
+
+    /// \brief Enables the converting constructor of optional<T> from an
+    ///        optional<U> whose value is accessed as \c Arg, which is
+    ///        implicit if and only if \c Implicit is \c true
+    template<typename T, typename U, typename Arg, bool Implicit>
+    using optional_converting_ctor_t = typename std::enable_if<
+      std::is_constructible<T,Arg>::value &&
+      !is_constructible_from_optional<T,U>::value &&
+      std::is_convertible<Arg,T>::value == Implicit,
+      int
+    >::type;
+
+    /// \brief Enables the converting assignment of optional<T> from an
+    ///        optional<U> whose value is accessed as \c Arg
+    template<typename T, typename U, typename Arg>
+    using optional_converting_assign_t = typename std::enable_if<
+      std::is_constructible<T,Arg>::value &&
+      std::is_assignable<T&,Arg>::value &&
+      !is_constructible_from_optional<T,U>::value &&
+      !is_assignable_from_optional<T,U>::value,
+      int
+    >::type;
+
+    /// \brief Enables the assignment of optional<T> from a value of type
+    ///        \c U
+    ///
+    /// As with std::optional, scalars are excluded when \c U is \c T
+    /// itself; those assignments go through the implicit constructor and
+    /// the trivial assignment instead.
+    template<typename T, typename U>
+    using optional_value_assign_t = typename std::enable_if<
+      !std::is_same<typename std::decay<U>::type,optional<T>>::value &&
+      std::is_constructible<T,U>::value &&
+      std::is_assignable<T&,U>::value &&
+      (!std::is_scalar<T>::value ||
+       !std::is_same<typename std::decay<U>::type,T>::value),
+      int
+    >::type;
+
+    /// \brief Enables constructing a \c T from \c Args
+    template<typename T, typename...Args>
+    using optional_construct_t = typename std::enable_if<
+      std::is_constructible<T,Args...>::value,
+      int
+    >::type;
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief Direct-initializes a \c T from \c Args within a single
+    ///        expression
+    ///
+    /// With a single argument, \c T(args...) is a functional cast, which
+    /// also allows the conversions of a C-style cast; this initializes
+    /// the value as \c T(value)(args...) would instead.
+    //////////////////////////////////////////////////////////////////////////
+    template<typename T>
+    struct optional_direct_init
+    {
+      template<typename...Args>
+      constexpr explicit optional_direct_init( Args&&...args );
+
+      T value; ///< The initialized value
+    };
+
+    /// \brief The type of the result of calling \c F with \c Args
+    ///
+    /// This is spelled out rather than using std::result_of, which was
+    /// removed in C++20; the monadic operations call \c F directly, so
+    /// member pointers need not be supported.
+    template<typename F, typename...Args>
+    using invoke_result_t = decltype(std::declval<F>()(std::declval<Args>()...));
+
+    /// \brief The optional returned by and_then, which is the result of
+    ///        invoking \c F with \c Arg
+    template<typename F, typename Arg>
+    using optional_and_then_t = typename std::remove_cv<
+      typename std::remove_reference<invoke_result_t<F,Arg>>::type
+    >::type;
+
+    /// \brief The optional returned by transform, which holds the result of
+    ///        invoking \c F with \c Arg
+    template<typename F, typename Arg>
+    using optional_transform_t = optional<typename std::remove_cv<invoke_result_t<F,Arg>>::type>;
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief Determines whether \c T is a final class
+    //////////////////////////////////////////////////////////////////////////
+    template<typename T>
+    struct is_final : std::integral_constant<bool,__is_final(T)>{};
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief Determines whether \c T may be stored as an empty base of the
+    ///        optional's storage
+    ///
+    /// The base subobject exists for the entire lifetime of the optional, so
+    /// this is only done when constructing and destroying it in the empty
+    /// state is unobservable.
+    //////////////////////////////////////////////////////////////////////////
+    template<typename T>
+    struct is_empty_storable
+      : std::integral_constant<bool,
+          std::is_empty<T>::value &&
+          !is_final<T>::value &&
+          std::is_trivially_default_constructible<T>::value &&
+          std::is_trivially_destructible<T>::value>{};
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief The storage of an optional value for empty types, which only
+    ///        stores the flag indicating whether or not it is engaged.
+    ///
+    /// \c T is held as an empty base so that it occupies no storage of its
+    /// own, and the whole optional is a single byte. Engaging the optional
+    /// constructs \c T in place over the base subobject.
+    //////////////////////////////////////////////////////////////////////////
+    template<typename T>
+    class optional_empty_storage : private T
+    {
+      //----------------------------------------------------------------------
+      // Constructor
+      //----------------------------------------------------------------------
+    protected:
+
+      constexpr optional_empty_storage() noexcept;
+
+      template<typename...Args>
+      constexpr explicit optional_empty_storage( in_place_t, Args&&...args );
+
+      constexpr explicit optional_empty_storage( optional_niche_state state ) noexcept;
+
+      //----------------------------------------------------------------------
+      // Protected Member Functions
+      //----------------------------------------------------------------------
+    protected:
+
+      T* val() noexcept;
+      constexpr const T* val() const noexcept;
+
+      constexpr bool has_value() const noexcept;
+
+      constexpr unsigned char niche_state() const noexcept;
+
+      void mark_engaged() noexcept;
+
+      void mark_disengaged() noexcept;
+
+      //----------------------------------------------------------------------
+      // Protected Members
+      //----------------------------------------------------------------------
+    protected:
+
+      unsigned char m_has_value; ///< 1 if the optional has a value
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief The first value of the state byte of \c T that no live \c T
+    ///        ever holds, or \c 0 if \c T has no such byte
+    ///
+    /// A \c bool has spare representations too, but a constant expression
+    /// cannot tell which member of a union is active, so an optional<bool>
+    /// that stored its empty state there could not be observed in one. The
+    /// single-byte alternative is optional<compact_bool>.
+    //////////////////////////////////////////////////////////////////////////
+    template<typename T, typename = void>
+    struct optional_niche : std::integral_constant<unsigned,0>{};
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief The storage of an optional<optional<U>>, which encodes its
+    ///        empty state in a spare value of the inner optional's state
+    ///        byte.
+    ///
+    /// The inner optional is always alive; a disengaged storage holds one
+    /// that was constructed with the state \c empty_state. The state is
+    /// therefore always read through a live member, which keeps the
+    /// storage usable in constant expressions.
+    //////////////////////////////////////////////////////////////////////////
+    template<typename T>
+    class optional_niche_storage
+    {
+      //----------------------------------------------------------------------
+      // Constructor
+      //----------------------------------------------------------------------
+    protected:
+
+      constexpr optional_niche_storage() noexcept;
+
+      template<typename...Args>
+      constexpr explicit optional_niche_storage( in_place_t, Args&&...args );
+
+      constexpr explicit optional_niche_storage( optional_niche_state state ) noexcept;
+
+      //----------------------------------------------------------------------
+      // Protected Member Functions
+      //----------------------------------------------------------------------
+    protected:
+
+      T* val() noexcept;
+      constexpr const T* val() const noexcept;
+
+      constexpr bool has_value() const noexcept;
+
+      constexpr unsigned char niche_state() const noexcept;
+
+      void mark_engaged() noexcept;
+
+      void mark_disengaged() noexcept;
+
+      //----------------------------------------------------------------------
+      // Protected Members
+      //----------------------------------------------------------------------
+    protected:
+
+      enum : unsigned char { empty_state = optional_niche<T>::value };
+
+      T m_value; ///< The inner optional, which is always alive
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief Determines whether \c T is an enumeration that declares a
+    ///        sentinel through optional_sentinel_traits
+    //////////////////////////////////////////////////////////////////////////
+    template<typename T, typename = void>
+    struct has_optional_sentinel : std::false_type{};
+
+    template<typename T>
+    struct has_optional_sentinel<T,decltype(void(optional_sentinel_traits<T>::empty_value()))>
+      : std::is_enum<T>{};
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief The storage of an optional enumeration that declares a
+    ///        sentinel value, which stores no separate flag.
+    ///
+    /// The enumeration is always alive; a disengaged optional holds the
+    /// sentinel declared by optional_sentinel_traits.
+    //////////////////////////////////////////////////////////////////////////
+    template<typename T>
+    class optional_sentinel_storage
+    {
+      using traits_type = optional_sentinel_traits<T>;
+
+      //----------------------------------------------------------------------
+      // Constructor
+      //----------------------------------------------------------------------
+    protected:
+
+      constexpr optional_sentinel_storage() noexcept;
+
+      template<typename...Args>
+      constexpr explicit optional_sentinel_storage( in_place_t, Args&&...args );
+
+      //----------------------------------------------------------------------
+      // Protected Member Functions
+      //----------------------------------------------------------------------
+    protected:
+
+      T* val() noexcept;
+      constexpr const T* val() const noexcept;
+
+      constexpr bool has_value() const noexcept;
+
+      void mark_engaged() noexcept;
+
+      void mark_disengaged() noexcept;
+
+      //----------------------------------------------------------------------
+      // Protected Members
+      //----------------------------------------------------------------------
+    protected:
+
+      T m_value; ///< The value, or the sentinel if disengaged
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief Selects the storage used for an optional of \c T
+    //////////////////////////////////////////////////////////////////////////
+    template<typename T, typename = void>
+    struct optional_storage_selector
+    {
+      using type = optional_destruct_base<T>;
+    };
+
+    template<typename T>
+    struct optional_storage_selector<T,typename std::enable_if<!optional_instrumented &&
+                                                               is_empty_storable<T>::value>::type>
+    {
+      using type = optional_empty_storage<T>;
+    };
+
+    template<typename T>
+    struct optional_storage_selector<T,typename std::enable_if<!optional_instrumented &&
+                                                               (optional_niche<T>::value != 0)>::type>
+    {
+      using type = optional_niche_storage<T>;
+    };
+
+    template<typename T>
+    struct optional_storage_selector<T,typename std::enable_if<!optional_instrumented &&
+                                                               has_optional_sentinel<T>::value>::type>
+    {
+      using type = optional_sentinel_storage<T>;
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief The first value of the state byte of the storage \c S that
+    ///        a live optional never holds, or \c 0 if there is no such value
+    ///
+    /// The flag of a flagged storage only holds \c 0 or \c 1; a niche
+    /// storage uses one more state than its value.
+    //////////////////////////////////////////////////////////////////////////
+    template<typename S>
+    struct optional_storage_niche : std::integral_constant<unsigned,0>{};
+
+    template<typename T, bool B>
+    struct optional_storage_niche<optional_destruct_base<T,B>>
+      : std::integral_constant<unsigned,2>{};
+
+    template<typename T>
+    struct optional_storage_niche<optional_empty_storage<T>>
+      : std::integral_constant<unsigned,2>{};
+
+    template<typename T>
+    struct optional_storage_niche<optional_niche_storage<T>>
+      : std::integral_constant<unsigned,(optional_niche<T>::value < 0xff) ? optional_niche<T>::value + 1 : 0>{};
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief An optional<T> leaves the spare states of its leading byte to
+    ///        an enclosing optional, so that optional<optional<T>> is no
+    ///        larger than optional<T>
+    //////////////////////////////////////////////////////////////////////////
+    template<typename T>
+    struct optional_niche<optional<T>,typename std::enable_if<!std::is_reference<T>::value>::type>
+      : optional_storage_niche<typename optional_storage_selector<T>::type>{};
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief The operations on the storage of an optional value, shared by
+    ///        every layer built on top of it.
+    ///
+    /// Each storage provides \c val(), \c has_value(), \c mark_engaged()
+    /// and \c mark_disengaged(); everything else is implemented here in
+    /// terms of them.
+    ///
+    /// The copy and move operations of this type are left trivial; the
+    /// layers built on top of it only introduce non-trivial operations when
+    /// the corresponding operation of \c T is non-trivial.
+    //////////////////////////////////////////////////////////////////////////
+    template<typename T>
+    class optional_storage : public optional_storage_selector<T>::type
+    {
+      using base_type = typename optional_storage_selector<T>::type;
+
+      //----------------------------------------------------------------------
+      // Constructor
+      //----------------------------------------------------------------------
+    protected:
+
+      using base_type::base_type;
+
+      optional_storage() = default;
+
+      //----------------------------------------------------------------------
+      // Protected Member Functions
+      //----------------------------------------------------------------------
+    protected:
+
+      using base_type::val;
+      using base_type::has_value;
+
+      /// \brief Constructs the value of a disengaged optional in-place
+      ///
+      /// \param args... the arguments to forward to the constructor
+      template<typename...Args>
+      void construct( Args&&...args );
+
+      /// \brief Destructs the value of the optional, if any, and disengages it
+      ///
+      /// Trivially destructible values have nothing to destroy, so the
+      /// optional is disengaged by an unconditional store without first
+      /// checking whether it holds a value.
+      void destruct() noexcept;
+
+      /// \brief Destructs the value of an optional known to be engaged, and
+      ///        disengages it
+      void destruct_engaged() noexcept;
+
+      //----------------------------------------------------------------------
+      // Private Member Functions
+      //----------------------------------------------------------------------
+    private:
+
+      /// \brief Whether the state of this storage is shared with its value
+      using is_niche = std::is_same<base_type,optional_niche_storage<T>>;
+
+      /// \brief Constructs the value, restoring the empty state if its
+      ///        constructor throws after overwriting the shared state byte
+      ///
+      /// \param args... the arguments to forward to the constructor
+      template<typename...Args>
+      void construct_value( std::true_type, Args&&...args );
+
+      /// \brief Constructs the value
+      ///
+      /// \param args... the arguments to forward to the constructor
+      template<typename...Args>
+      void construct_value( std::false_type, Args&&...args );
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief Introduces a non-trivial copy constructor when \c T is not
+    ///        trivially copy-constructible, and deletes it when \c T is not
+    ///        copy-constructible
+    //////////////////////////////////////////////////////////////////////////
+    template<typename T,
+             bool = !optional_instrumented &&
+                    std::is_trivially_copy_constructible<T>::value,
+             bool = std::is_copy_constructible<T>::value>
+    class optional_copy_ctor_base : public optional_storage<T>
+    {
+    protected:
+
+      using optional_storage<T>::optional_storage;
+
+      optional_copy_ctor_base() = default;
+    };
+
+    template<typename T>
+    class optional_copy_ctor_base<T,false,false> : public optional_storage<T>
+    {
+    protected:
+
+      using optional_storage<T>::optional_storage;
+
+      optional_copy_ctor_base() = default;
+      optional_copy_ctor_base( const optional_copy_ctor_base& other ) = delete;
+      optional_copy_ctor_base( optional_copy_ctor_base&& other ) = default;
+      optional_copy_ctor_base& operator=( const optional_copy_ctor_base& other ) = default;
+      optional_copy_ctor_base& operator=( optional_copy_ctor_base&& other ) = default;
+    };
+
+    template<typename T>
+    class optional_copy_ctor_base<T,false,true> : public optional_storage<T>
+    {
+    protected:
+
+      using optional_storage<T>::optional_storage;
+
+      optional_copy_ctor_base() = default;
+      optional_copy_ctor_base( const optional_copy_ctor_base& other )
+        noexcept(std::is_nothrow_copy_constructible<T>::value);
+      optional_copy_ctor_base( optional_copy_ctor_base&& other ) = default;
+      optional_copy_ctor_base& operator=( const optional_copy_ctor_base& other ) = default;
+      optional_copy_ctor_base& operator=( optional_copy_ctor_base&& other ) = default;
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief Introduces a non-trivial move constructor when \c T is not
+    ///        trivially move-constructible, and deletes it when \c T is not
+    ///        move-constructible
+    //////////////////////////////////////////////////////////////////////////
+    template<typename T,
+             bool = !optional_instrumented &&
+                    std::is_trivially_move_constructible<T>::value,
+             bool = std::is_move_constructible<T>::value>
+    class optional_move_ctor_base : public optional_copy_ctor_base<T>
+    {
+    protected:
+
+      using optional_copy_ctor_base<T>::optional_copy_ctor_base;
+
+      optional_move_ctor_base() = default;
+    };
+
+    template<typename T>
+    class optional_move_ctor_base<T,false,false> : public optional_copy_ctor_base<T>
+    {
+    protected:
+
+      using optional_copy_ctor_base<T>::optional_copy_ctor_base;
+
+      optional_move_ctor_base() = default;
+      optional_move_ctor_base( const optional_move_ctor_base& other ) = default;
+      optional_move_ctor_base( optional_move_ctor_base&& other ) = delete;
+      optional_move_ctor_base& operator=( const optional_move_ctor_base& other ) = default;
+      optional_move_ctor_base& operator=( optional_move_ctor_base&& other ) = default;
+    };
+
+    template<typename T>
+    class optional_move_ctor_base<T,false,true> : public optional_copy_ctor_base<T>
+    {
+    protected:
+
+      using optional_copy_ctor_base<T>::optional_copy_ctor_base;
+
+      optional_move_ctor_base() = default;
+      optional_move_ctor_base( const optional_move_ctor_base& other ) = default;
+      optional_move_ctor_base( optional_move_ctor_base&& other )
+        noexcept(std::is_nothrow_move_constructible<T>::value);
+      optional_move_ctor_base& operator=( const optional_move_ctor_base& other ) = default;
+      optional_move_ctor_base& operator=( optional_move_ctor_base&& other ) = default;
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief Introduces a non-trivial copy assignment when \c T is not
+    ///        trivially copy-constructible, copy-assignable and destructible,
+    ///        and deletes it when \c T is not copy-constructible and
+    ///        copy-assignable
+    //////////////////////////////////////////////////////////////////////////
+    template<typename T,
+             bool = !optional_instrumented &&
+                    std::is_trivially_copy_constructible<T>::value &&
+                    std::is_trivially_copy_assignable<T>::value &&
+                    std::is_trivially_destructible<T>::value,
+             bool = std::is_copy_constructible<T>::value &&
+                    std::is_copy_assignable<T>::value>
+    class optional_copy_assign_base : public optional_move_ctor_base<T>
+    {
+    protected:
+
+      using optional_move_ctor_base<T>::optional_move_ctor_base;
+
+      optional_copy_assign_base() = default;
+    };
+
+    template<typename T>
+    class optional_copy_assign_base<T,false,false> : public optional_move_ctor_base<T>
+    {
+    protected:
+
+      using optional_move_ctor_base<T>::optional_move_ctor_base;
+
+      optional_copy_assign_base() = default;
+      optional_copy_assign_base( const optional_copy_assign_base& other ) = default;
+      optional_copy_assign_base( optional_copy_assign_base&& other ) = default;
+      optional_copy_assign_base& operator=( const optional_copy_assign_base& other ) = delete;
+      optional_copy_assign_base& operator=( optional_copy_assign_base&& other ) = default;
+    };
+
+    template<typename T>
+    class optional_copy_assign_base<T,false,true> : public optional_move_ctor_base<T>
+    {
+    protected:
+
+      using optional_move_ctor_base<T>::optional_move_ctor_base;
+
+      optional_copy_assign_base() = default;
+      optional_copy_assign_base( const optional_copy_assign_base& other ) = default;
+      optional_copy_assign_base( optional_copy_assign_base&& other ) = default;
+      optional_copy_assign_base& operator=( const optional_copy_assign_base& other )
+        noexcept(std::is_nothrow_copy_constructible<T>::value &&
+                 std::is_nothrow_copy_assignable<T>::value);
+      optional_copy_assign_base& operator=( optional_copy_assign_base&& other ) = default;
+    };
+
+    //////////////////////////////////////////////////////////////////////////
+    /// \brief Introduces a non-trivial move assignment when \c T is not
+    ///        trivially move-constructible, move-assignable and destructible,
+    ///        and deletes it when \c T is not move-constructible and
+    ///        move-assignable
+    //////////////////////////////////////////////////////////////////////////
+    template<typename T,
+             bool = !optional_instrumented &&
+                    std::is_trivially_move_constructible<T>::value &&
+                    std::is_trivially_move_assignable<T>::value &&
+                    std::is_trivially_destructible<T>::value,
+             bool = std::is_move_constructible<T>::value &&
+                    std::is_move_assignable<T>::value>
+    class optional_move_assign_base : public optional_copy_assign_base<T>
+    {
+    protected:
+
+      using optional_copy_assign_base<T>::optional_copy_assign_base;
+
+      optional_move_assign_base() = default;
+    };
+
+    template<typename T>
+    class optional_move_assign_base<T,false,false> : public optional_copy_assign_base<T>
+    {
+    protected:
+
+      using optional_copy_assign_base<T>::optional_copy_assign_base;
+
+      optional_move_assign_base() = default;
+      optional_move_assign_base( const optional_move_assign_base& other ) = default;
+      optional_move_assign_base( optional_move_assign_base&& other ) = default;
+      optional_move_assign_base& operator=( const optional_move_assign_base& other ) = default;
+      optional_move_assign_base& operator=( optional_move_assign_base&& other ) = delete;
+    };
+
+    template<typename T>
+    class optional_move_assign_base<T,false,true> : public optional_copy_assign_base<T>
+    {
+    protected:
+
+      using optional_copy_assign_base<T>::optional_copy_assign_base;
+
+      optional_move_assign_base() = default;
+      optional_move_assign_base( const optional_move_assign_base& other ) = default;
+      optional_move_assign_base( optional_move_assign_base&& other ) = default;
+      optional_move_assign_base& operator=( const optional_move_assign_base& other ) = default;
+      optional_move_assign_base& operator=( optional_move_assign_base&& other )
+        noexcept(std::is_nothrow_move_constructible<T>::value &&
+                 std::is_nothrow_move_assignable<T>::value);
+    };
+
+  } // namespace detail
+
   ////////////////////////////////////////////////////////////////////////////
   /// \class bpstd::optional
   ///
@@ -62,10 +1121,30 @@ namespace bpstd {
   ///   object that does not contain a value.
   /// - The object is assigned from a value of nullopt_t or from an optional
   ///   that does not contain a value
+  ///
+  /// The copy, move and destruction operations of optional<T> are trivial
+  /// whenever the corresponding operations of T are trivial, so that
+  /// optionals of trivially copyable types are themselves trivially copyable
+  /// and may be passed in registers.
+  ///
+  /// An optional of a literal type is itself a literal type, and may be
+  /// constructed and observed in constant expressions.
+  ///
+  /// Pointers and smart pointers keep a separate flag: a null pointer is a
+  /// valid engaged value of optional<T*>, distinct from an empty optional.
+  /// std::reference_wrapper keeps one too, since its only spare value is a
+  /// wrapper bound to a sentinel object, which cannot be formed in a
+  /// constant expression. compact_optional reserves null, or that sentinel,
+  /// as the empty state for these types instead.
   ////////////////////////////////////////////////////////////////////////////
   template<typename T>
-  class optional final
+  class optional final : private detail::optional_move_assign_base<T>
   {
+    using base_type = detail::optional_move_assign_base<T>;
+
+    template<typename>
+    friend class detail::optional_niche_storage;
+
     //------------------------------------------------------------------------
     // Public Member Types
     //------------------------------------------------------------------------
@@ -78,27 +1157,60 @@ namespace bpstd {
     //------------------------------------------------------------------------
   public:
 
-    constexpr optional();
+    constexpr optional() noexcept;
 
-    constexpr optional( nullopt_t );
+    constexpr optional( nullopt_t ) noexcept;
 
-    optional( const optional& other );
+    optional( const optional& other ) = default;
 
-    optional( optional&& other );
+    optional( optional&& other ) = default;
 
-    optional( const value_type& value );
+    constexpr optional( const value_type& value );
 
-    optional( value_type&& value );
+    constexpr optional( value_type&& value );
 
     template<typename...Args>
-    explicit optional( in_place_t, Args&&... args );
+    constexpr explicit optional( in_place_t, Args&&... args );
 
     template<typename U, typename...Args>
-    explicit optional( in_place_t,
+    constexpr explicit optional( in_place_t,
                        std::initializer_list<U> ilist,
                        Args&&...args );
 
-    ~optional();
+    /// \brief Constructs an optional by converting the value of \p other,
+    ///        if it has one
+    ///
+    /// This is explicit if and only if \c const \c U& is not implicitly
+    /// convertible to \c T.
+    ///
+    /// \param other the optional to convert
+    template<typename U,
+             detail::optional_converting_ctor_t<T,U,const U&,true> = 0>
+    optional( const optional<U>& other );
+
+    /// \copydoc optional( const optional<U>& )
+    template<typename U,
+             detail::optional_converting_ctor_t<T,U,const U&,false> = 0>
+    explicit optional( const optional<U>& other );
+
+    /// \brief Constructs an optional by converting the value of \p other,
+    ///        if it has one
+    ///
+    /// The value of \p other is moved directly into the new value, without
+    /// an intermediate \c T. This is explicit if and only if \c U&& is not
+    /// implicitly convertible to \c T.
+    ///
+    /// \param other the optional to convert
+    template<typename U,
+             detail::optional_converting_ctor_t<T,U,U&&,true> = 0>
+    optional( optional<U>&& other );
+
+    /// \copydoc optional( optional<U>&& )
+    template<typename U,
+             detail::optional_converting_ctor_t<T,U,U&&,false> = 0>
+    explicit optional( optional<U>&& other );
+
+    ~optional() = default;
 
 
     //------------------------------------------------------------------------
@@ -106,27 +1218,72 @@ namespace bpstd {
     //------------------------------------------------------------------------
   public:
 
-    optional& operator=( nullopt_t );
-    optional& operator=( const optional& other );
-    optional& operator=( optional&& other );
-    template<typename U, typename = typename std::is_same<typename std::decay<U>::type, T>::value>
+    optional& operator=( nullopt_t ) noexcept;
+    optional& operator=( const optional& other ) = default;
+    optional& operator=( optional&& other ) = default;
+
+    /// \brief Assigns \p value to the contained value, or constructs it
+    ///        from \p value if \c *this is empty
+    ///
+    /// \param value the value to assign
+    /// \return reference to \c (*this)
+    template<typename U=T, detail::optional_value_assign_t<T,U> = 0>
     optional& operator=( U&& value );
 
+    /// \brief Assigns the converted value of \p other, or resets \c *this
+    ///        if \p other is empty
+    ///
+    /// \param other the optional to convert
+    /// \return reference to \c (*this)
+    template<typename U,
+             detail::optional_converting_assign_t<T,U,const U&> = 0>
+    optional& operator=( const optional<U>& other );
+
+    /// \brief Assigns the converted value of \p other, or resets \c *this
+    ///        if \p other is empty
+    ///
+    /// The value of \p other is moved directly, without an intermediate
+    /// \c T.
+    ///
+    /// \param other the optional to convert
+    /// \return reference to \c (*this)
+    template<typename U,
+             detail::optional_converting_assign_t<T,U,U&&> = 0>
+    optional& operator=( optional<U>&& other );
+
     //------------------------------------------------------------------------
     // Observers
     //------------------------------------------------------------------------
   public:
 
+    /// \brief Accesses the contained value.
+    ///
+    /// The behavior is undefined if \c *this does not contain a value. When
+    /// \c BPSTD_OPTIONAL_HARDENED is enabled, this is checked and the
+    /// program is aborted instead.
+    ///
+    /// \return a pointer to the contained value
     value_type* operator->() noexcept;
 
+    /// \copydoc operator->()
     constexpr const value_type* operator->() const noexcept;
 
+    /// \brief Accesses the contained value.
+    ///
+    /// The behavior is undefined if \c *this does not contain a value. When
+    /// \c BPSTD_OPTIONAL_HARDENED is enabled, this is checked and the
+    /// program is aborted instead.
+    ///
+    /// \return a reference to the contained value
     value_type& operator*() & noexcept;
 
+    /// \copydoc operator*() &
     value_type&& operator*() && noexcept;
 
+    /// \copydoc operator*() &
     constexpr const value_type& operator*() const& noexcept;
 
+    /// \copydoc operator*() &
     constexpr const value_type&& operator*() const&& noexcept;
 
     /// \brief Checks whether \c *this contains a value
@@ -167,6 +1324,24 @@ namespace bpstd {
     /// \copydoc value() &&
     constexpr const value_type&& value() const &&;
 
+    /// \brief Returns the contained value, without any check.
+    ///
+    /// This is never checked, even when \c BPSTD_OPTIONAL_HARDENED is
+    /// enabled; it is intended for audited paths where \c *this is known to
+    /// contain a value. The behavior is undefined if it does not.
+    ///
+    /// \return the value of \c *this
+    value_type& unchecked_value() & noexcept;
+
+    /// \copydoc unchecked_value() &
+    value_type&& unchecked_value() && noexcept;
+
+    /// \copydoc unchecked_value() &
+    constexpr const value_type& unchecked_value() const & noexcept;
+
+    /// \copydoc unchecked_value() &
+    constexpr const value_type&& unchecked_value() const && noexcept;
+
     //------------------------------------------------------------------------
 
     /// \brief Returns the contained value if \c *this has a value,
@@ -181,15 +1356,120 @@ namespace bpstd {
     template<typename U>
     value_type value_or( U&& default_value ) &&;
 
+    /// \brief Returns the contained value if \c *this has a value,
+    ///        otherwise returns the result of invoking \p f.
+    ///
+    /// Unlike value_or, the fallback is only computed if \c *this is empty.
+    ///
+    /// \param f a function, callable with no arguments, returning the value
+    ///          to use in case \c *this is empty
+    /// \return the contained value, or the result of \p f
+    template<typename F>
+    constexpr value_type value_or_else( F&& f ) const &;
+
+    /// \copydoc value_or_else( F&& ) const &
+    template<typename F>
+    value_type value_or_else( F&& f ) &&;
+
+    /// \brief Returns the contained value if \c *this has a value,
+    ///        otherwise returns a value constructed from \p args.
+    ///
+    /// Unlike value_or, the fallback is only constructed if \c *this is
+    /// empty.
+    ///
+    /// \param args... the arguments to construct the fallback from
+    /// \return the contained value, or a value constructed from \p args
+    template<typename...Args,
+             detail::optional_construct_t<T,Args...> = 0>
+    constexpr value_type value_or_construct( Args&&...args ) const &;
+
+    /// \copydoc value_or_construct( Args&&... ) const &
+    template<typename...Args,
+             detail::optional_construct_t<T,Args...> = 0>
+    value_type value_or_construct( Args&&...args ) &&;
+
+    //------------------------------------------------------------------------
+    // Monadic Operations
+    //------------------------------------------------------------------------
+  public:
+
+    /// \brief Invokes \p f with the contained value if \c *this has a
+    ///        value, otherwise returns an empty optional.
+    ///
+    /// The contained value is passed with the value category of \c *this,
+    /// so chains on rvalue optionals move the value through each stage.
+    ///
+    /// \param f a function taking the value and returning an optional
+    /// \return the result of \p f, or an empty optional
+    template<typename F>
+    detail::optional_and_then_t<F,value_type&> and_then( F&& f ) &;
+
+    /// \copydoc and_then( F&& ) &
+    template<typename F>
+    constexpr detail::optional_and_then_t<F,const value_type&> and_then( F&& f ) const &;
+
+    /// \copydoc and_then( F&& ) &
+    template<typename F>
+    detail::optional_and_then_t<F,value_type&&> and_then( F&& f ) &&;
+
+    /// \copydoc and_then( F&& ) &
+    template<typename F>
+    constexpr detail::optional_and_then_t<F,const value_type&&> and_then( F&& f ) const &&;
+
+    /// \brief Returns an optional holding the result of invoking \p f with
+    ///        the contained value if \c *this has a value, otherwise
+    ///        returns an empty optional.
+    ///
+    /// The contained value is passed with the value category of \c *this,
+    /// so chains on rvalue optionals move the value through each stage.
+    ///
+    /// \param f a function taking the value
+    /// \return an optional holding the result of \p f, or an empty optional
+    template<typename F>
+    detail::optional_transform_t<F,value_type&> transform( F&& f ) &;
+
+    /// \copydoc transform( F&& ) &
+    template<typename F>
+    constexpr detail::optional_transform_t<F,const value_type&> transform( F&& f ) const &;
+
+    /// \copydoc transform( F&& ) &
+    template<typename F>
+    detail::optional_transform_t<F,value_type&&> transform( F&& f ) &&;
+
+    /// \copydoc transform( F&& ) &
+    template<typename F>
+    constexpr detail::optional_transform_t<F,const value_type&&> transform( F&& f ) const &&;
+
+    /// \brief Returns \c *this if it has a value, otherwise returns the
+    ///        result of invoking \p f.
+    ///
+    /// Lvalues and const rvalues bind to the \c const& overload and are
+    /// copied; non-const rvalues are moved.
+    ///
+    /// \param f a function, callable with no arguments, returning an
+    ///          optional<T>
+    /// \return \c *this, or the result of \p f
+    template<typename F>
+    constexpr optional or_else( F&& f ) const &;
+
+    /// \copydoc or_else( F&& ) const &
+    template<typename F>
+    optional or_else( F&& f ) &&;
+
     //------------------------------------------------------------------------
     // Modifiers
     //------------------------------------------------------------------------
   public:
 
+    /// \brief Destroys the contained value, if any, leaving \c *this empty.
+    void reset() noexcept;
+
     /// \brief Swaps the contents with those of other.
     ///
     /// \param other the optional object to exchange the contents with
-    void swap( optional& other );
+    void swap( optional& other )
+      noexcept(std::is_nothrow_move_constructible<T>::value &&
+               detail::is_nothrow_swappable<T>::value);
 
     /// \brief Constructs the contained value in-place.
     ///
@@ -197,8 +1477,10 @@ namespace bpstd {
     /// value is destroyed by calling its destructor.
     ///
     /// \param args... the arguments to pass to the constructor
+    /// \return a reference to the new value
     template<typename...Args>
-    void emplace( Args&&...args );
+    value_type& emplace( Args&&...args )
+      noexcept(std::is_nothrow_constructible<T,Args...>::value);
 
     /// \brief Constructs the contained value in-place.
     ///
@@ -207,39 +1489,239 @@ namespace bpstd {
     ///
     /// \param ilist   the initializer list to pass to the constructor
     /// \param args... the arguments to pass to the constructor
+    /// \return a reference to the new value
     template<typename U,typename...Args >
-    void emplace( std::initializer_list<U> ilist, Args&&...args );
+    value_type& emplace( std::initializer_list<U> ilist, Args&&...args )
+      noexcept(std::is_nothrow_constructible<T,std::initializer_list<U>&,Args...>::value);
+
+    /// \brief Returns the contained value, constructing it in-place first
+    ///        if \c *this is empty.
+    ///
+    /// This is intended for lazily-initialized slots; the engaged state is
+    /// checked once, and an existing value is left untouched.
+    ///
+    /// \param args... the arguments to pass to the constructor
+    /// \return a reference to the contained value
+    template<typename...Args>
+    value_type& get_or_emplace( Args&&...args )
+      noexcept(std::is_nothrow_constructible<T,Args...>::value);
+
+    /// \brief Returns the contained value, constructing it in-place from
+    ///        the result of invoking \p f first if \c *this is empty.
+    ///
+    /// \p f is only invoked if \c *this is empty.
+    ///
+    /// \param f a function, callable with no arguments, returning the value
+    ///          to construct
+    /// \return a reference to the contained value
+    template<typename F>
+    value_type& get_or_emplace_with( F&& f );
+
+    /// \brief Moves the contained value out, leaving \c *this empty.
+    ///
+    /// The contained value is destroyed immediately after it is moved from,
+    /// rather than remaining in a moved-from state until \c *this is reset
+    /// or destroyed.
+    ///
+    /// \return an optional containing the previous value, if any
+    optional take()
+      noexcept(std::is_nothrow_move_constructible<T>::value);
+
+    /// \brief Replaces the contained value with one constructed from
+    ///        \p value, returning the previous value.
+    ///
+    /// \p value may refer to the contained value; the replacement is
+    /// constructed before the previous value is moved out.
+    ///
+    /// \param value the value to construct the new contained value from
+    /// \return an optional containing the previous value, if any
+    template<typename U=T>
+    optional replace( U&& value )
+      noexcept(std::is_nothrow_move_constructible<T>::value &&
+               std::is_nothrow_constructible<T,U>::value);
 
     //------------------------------------------------------------------------
-    // Private Member Types
+    // Private Member Functions
     //------------------------------------------------------------------------
   private:
 
-    using storage_type = typename std::aligned_storage<sizeof(T),alignof(T)>::type;
+    /// \brief Constructs a disengaged optional whose state byte holds
+    ///        \p state, for an enclosing optional that is empty
+    ///
+    /// \param state the state byte of the enclosing optional
+    constexpr explicit optional( detail::optional_niche_state state ) noexcept;
+
+    /// \brief Gets the state byte, which enclosing optionals share
+    ///
+    /// \return the state byte
+    constexpr unsigned char niche_state() const noexcept;
+
+    using base_type::has_value;
+    using base_type::val;
+    using base_type::construct;
+    using base_type::destruct;
+    using base_type::destruct_engaged;
+
+    /// \brief Whether optionals of \c T are small and trivially copyable
+    ///        enough to be swapped whole, without branching on which side
+    ///        is engaged
+    using is_swapped_whole = std::integral_constant<bool,
+      std::is_trivially_copyable<T>::value &&
+      sizeof(T) <= 2 * sizeof(void*) &&
+      !detail::optional_instrumented
+    >;
+
+    /// \brief Swaps the contents with those of \p other as whole objects
+    ///
+    /// \param other the optional object to exchange the contents with
+    void swap_impl( optional& other, std::true_type ) noexcept;
+
+    /// \brief Swaps the contents with those of \p other value by value
+    ///
+    /// \param other the optional object to exchange the contents with
+    void swap_impl( optional& other, std::false_type )
+      noexcept(std::is_nothrow_move_constructible<T>::value &&
+               detail::is_nothrow_swappable<T>::value);
+  };
 
+  ////////////////////////////////////////////////////////////////////////////
+  /// \brief A partial specialization of optional for lvalue references.
+  ///
+  /// An optional<T&> either refers to an object of type \c T or refers to
+  /// nothing. It is represented by a single pointer, so it is exactly
+  /// pointer-sized and trivially copyable, and may be returned from lookups
+  /// without copying the referenced value.
+  ///
+  /// Unlike optional<T>, assigning to an optional<T&> rebinds the reference
+  /// rather than assigning through it. Binding to temporaries is disallowed.
+  ////////////////////////////////////////////////////////////////////////////
+  template<typename T>
+  class optional<T&> final
+  {
     //------------------------------------------------------------------------
-    // Private Members
+    // Public Member Types
     //------------------------------------------------------------------------
-  private:
+  public:
 
-    storage_type m_value;      ///< The value of this optional
-    mutable bool m_has_value;  ///< Whether or not the optional has a value
+    using value_type = T&;
 
     //------------------------------------------------------------------------
-    // Private Member Functions
+    // Constructor / Destructor
     //------------------------------------------------------------------------
-  private:
+  public:
+
+    constexpr optional() noexcept;
+
+    constexpr optional( nullopt_t ) noexcept;
+
+    optional( const optional& other ) = default;
+
+    optional( optional&& other ) = default;
+
+    constexpr optional( T& value ) noexcept;
+
+    optional( T&& value ) = delete;
+
+    ~optional() = default;
 
-    /// \brief Gets a pointer to the value type
+    //------------------------------------------------------------------------
+    // Assignment
+    //------------------------------------------------------------------------
+  public:
+
+    optional& operator=( nullopt_t ) noexcept;
+    optional& operator=( const optional& other ) = default;
+    optional& operator=( optional&& other ) = default;
+
+    //------------------------------------------------------------------------
+    // Observers
+    //------------------------------------------------------------------------
+  public:
+
+    /// \brief Accesses the referenced object.
+    ///
+    /// The behavior is undefined if \c *this does not refer to an object.
+    /// When \c BPSTD_OPTIONAL_HARDENED is enabled, this is checked and the
+    /// program is aborted instead.
     ///
-    /// \return the pointer
-    constexpr T* val() const noexcept;
+    /// \return a pointer to the referenced object
+    constexpr T* operator->() const noexcept;
 
-    /// \brief Destructs the value of the optional if it is not trivially destructible
-    void destruct() const;
+    /// \copydoc operator->()
+    ///
+    /// \return the referenced object
+    constexpr T& operator*() const noexcept;
 
+    /// \brief Checks whether \c *this refers to an object
+    ///
+    /// \return \c true if \c *this refers to an object
+    constexpr explicit operator bool() const noexcept;
+
+    //------------------------------------------------------------------------
+
+    /// \brief Returns the referenced object.
+    ///
+    /// \throws #bad_optional_access if \c *this does not refer to an object.
+    ///
+    /// \return the referenced object
+    constexpr T& value() const;
+
+    /// \brief Returns the referenced object, without any check.
+    ///
+    /// The behavior is undefined if \c *this does not refer to an object.
+    ///
+    /// \return the referenced object
+    constexpr T& unchecked_value() const noexcept;
+
+    /// \brief Returns the referenced object if \c *this refers to one,
+    ///        otherwise returns \p default_value.
+    ///
+    /// No copy is made in either case.
+    ///
+    /// \param default_value the object to refer to in case \c *this is empty
+    /// \return the referenced object, or \p default_value
+    constexpr T& value_or( T& default_value ) const noexcept;
+
+    T& value_or( T&& default_value ) const = delete;
+
+    //------------------------------------------------------------------------
+    // Modifiers
+    //------------------------------------------------------------------------
+  public:
+
+    /// \brief Swaps the referenced objects with those of other.
+    ///
+    /// \param other the optional object to exchange the contents with
+    void swap( optional& other ) noexcept;
+
+    /// \brief Rebinds this optional to refer to \p value
+    ///
+    /// \param value the object to refer to
+    T& emplace( T& value ) noexcept;
+
+    //------------------------------------------------------------------------
+    // Private Members
+    //------------------------------------------------------------------------
+  private:
+
+    T* m_value; ///< The referenced object, or \c nullptr if disengaged
   };
 
+  //--------------------------------------------------------------------------
+  // Utilities
+  //--------------------------------------------------------------------------
+
+  /// \brief Swaps the contents of \p lhs with those of \p rhs
+  ///
+  /// This is found by argument-dependent lookup, so that generic code and
+  /// standard algorithms use optional's swap rather than three moves.
+  ///
+  /// \param lhs the first optional to swap
+  /// \param rhs the second optional to swap
+  template<typename T>
+  void swap( optional<T>& lhs, optional<T>& rhs )
+    noexcept(noexcept(lhs.swap(rhs)));
+
 } // namespace bpstd
 
 #include "detail/optional.inl"
@@ -0,0 +1,468 @@
+/**
+ * \file compact_optional.test.cpp
+ *
+ * \brief Unit tests for #bpstd::compact_optional
+ */
+
+#include <bpstd/compact_optional.hpp>
+
+#include "../catch.hpp"
+
+#include <climits>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+
+namespace {
+
+  using int_traits = bpstd::value_sentinel_traits<int,INT_MIN>;
+  using compact_int = bpstd::compact_optional<int,int_traits>;
+
+  /// \brief A user type that declares its own sentinel through the
+  ///        compact_optional_traits customization point
+  struct handle
+  {
+    std::size_t index;
+  };
+
+} // namespace
+
+namespace bpstd {
+  template<>
+  struct compact_optional_traits<handle>
+  {
+    static constexpr handle empty_value() noexcept
+    {
+      return handle{std::size_t(-1)};
+    }
+
+    static constexpr bool is_empty_value( const handle& value ) noexcept
+    {
+      return value.index == std::size_t(-1);
+    }
+  };
+} // namespace bpstd
+
+//----------------------------------------------------------------------------
+// Layout
+//----------------------------------------------------------------------------
+
+static_assert( sizeof(compact_int) == sizeof(int),
+               "compact_optional must be the size of its value" );
+static_assert( sizeof(bpstd::compact_optional<handle>) == sizeof(handle),
+               "compact_optional must be the size of its value" );
+static_assert( std::is_trivially_copyable<compact_int>::value,
+               "compact_optional<int> must be trivially copyable" );
+static_assert( sizeof(bpstd::compact_optional<int*>) == sizeof(int*),
+               "compact_optional<T*> must be the size of a pointer" );
+static_assert( sizeof(bpstd::compact_optional<std::unique_ptr<int>>) == sizeof(int*),
+               "compact_optional<unique_ptr<T>> must be the size of a pointer" );
+static_assert( sizeof(bpstd::compact_optional<std::reference_wrapper<int>>) == sizeof(int*),
+               "compact_optional<reference_wrapper<T>> must be the size of a pointer" );
+static_assert( sizeof(bpstd::compact_optional<double>) == sizeof(double),
+               "compact_optional<double> must be the size of a double" );
+static_assert( sizeof(bpstd::compact_optional<float>) == sizeof(float),
+               "compact_optional<float> must be the size of a float" );
+static_assert( noexcept(swap(std::declval<compact_int&>(),std::declval<compact_int&>())),
+               "swap( compact_optional&, compact_optional& ) must be noexcept" );
+static_assert( !compact_int(), "compact_optional() must be constexpr" );
+static_assert( !bpstd::compact_optional<int*>(), "compact_optional<T*>() must be constexpr" );
+static_assert( static_cast<bool>(compact_int(42)), "compact_optional( T&& ) must be constexpr" );
+
+//----------------------------------------------------------------------------
+// Constructors
+//----------------------------------------------------------------------------
+
+TEST_CASE("compact_optional::compact_optional()","[ctor]")
+{
+  auto optional = compact_int();
+
+  SECTION("Has no value")
+  {
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Holds the sentinel value")
+  {
+    REQUIRE( optional.unchecked_value() == INT_MIN );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("compact_optional::compact_optional( nullopt_t )","[ctor]")
+{
+  auto optional = bpstd::compact_optional<handle>( bpstd::nullopt );
+
+  SECTION("Has no value")
+  {
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("compact_optional::compact_optional( const value_type& )","[ctor]")
+{
+  auto value    = 42;
+  auto optional = compact_int(value);
+
+  SECTION("Has a value")
+  {
+    REQUIRE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Value is the same as original")
+  {
+    REQUIRE( optional.value() == value );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("compact_optional::compact_optional( in_place_t, Args&&... )","[ctor]")
+{
+  auto optional = bpstd::compact_optional<handle>( bpstd::in_place, handle{5} );
+
+  SECTION("Has a value")
+  {
+    REQUIRE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Value is constructed from arguments")
+  {
+    REQUIRE( optional->index == 5u );
+  }
+}
+
+//----------------------------------------------------------------------------
+// Assignment
+//----------------------------------------------------------------------------
+
+TEST_CASE("compact_optional::operator=( nullopt_t )","[assignment]")
+{
+  auto optional = compact_int(42);
+  optional = bpstd::nullopt;
+
+  SECTION("Converts to null")
+  {
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("compact_optional::operator=( const compact_optional& )","[assignment]")
+{
+  SECTION("Assigning null over non-null value")
+  {
+    auto original = compact_int();
+    auto optional = compact_int(42);
+    optional = original;
+
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Assigning non-null over null value")
+  {
+    auto original = compact_int(42);
+    auto optional = compact_int();
+    optional = original;
+
+    REQUIRE( optional.value() == 42 );
+  }
+}
+
+//----------------------------------------------------------------------------
+// Observers
+//----------------------------------------------------------------------------
+
+TEST_CASE("compact_optional::value()","[observers]")
+{
+  SECTION("Optional is null")
+  {
+    auto optional = compact_int();
+
+    REQUIRE_THROWS_AS( optional.value(), const bpstd::bad_optional_access& );
+  }
+
+  SECTION("Optional is non-null")
+  {
+    auto optional = compact_int(42);
+
+    REQUIRE( optional.value() == 42 );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("compact_optional::unchecked_value()","[observers]")
+{
+  SECTION("Returns the contained value")
+  {
+    auto optional = compact_int(42);
+
+    REQUIRE( optional.unchecked_value() == 42 );
+  }
+
+  SECTION("Moves the contained value from an rvalue")
+  {
+    auto optional = bpstd::compact_optional<std::unique_ptr<int>>( std::unique_ptr<int>(new int(42)) );
+    auto value = std::move(optional).unchecked_value();
+
+    REQUIRE( *value == 42 );
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("compact_optional::value_or( U&& )","[observers]")
+{
+  SECTION("Optional is null")
+  {
+    auto optional = compact_int();
+
+    REQUIRE( optional.value_or(42) == 42 );
+  }
+
+  SECTION("Optional is non-null")
+  {
+    auto optional = compact_int(32);
+
+    REQUIRE( std::move(optional).value_or(42) == 32 );
+  }
+}
+
+//----------------------------------------------------------------------------
+// Modifiers
+//----------------------------------------------------------------------------
+
+TEST_CASE("compact_optional::swap( compact_optional& )","[modifiers]")
+{
+  auto op1 = compact_int(32);
+  auto op2 = compact_int();
+
+  op1.swap(op2);
+
+  SECTION("op1 is null")
+  {
+    REQUIRE_FALSE( static_cast<bool>(op1) );
+  }
+
+  SECTION("op2 contains op1's value")
+  {
+    REQUIRE( op2.value() == 32 );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("swap( compact_optional&, compact_optional& )","[modifiers]")
+{
+  auto op1 = compact_int(32);
+  auto op2 = compact_int();
+
+  using std::swap;
+  swap(op1,op2);
+
+  SECTION("op1 is null")
+  {
+    REQUIRE_FALSE( static_cast<bool>(op1) );
+  }
+
+  SECTION("op2 contains op1's value")
+  {
+    REQUIRE( op2.value() == 32 );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("compact_optional::emplace( Args&&... )","[modifiers]")
+{
+  auto optional = bpstd::compact_optional<handle>();
+  optional.emplace( handle{3} );
+
+  SECTION("Has a value")
+  {
+    REQUIRE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Value is constructed from arguments")
+  {
+    REQUIRE( optional->index == 3u );
+  }
+}
+
+//----------------------------------------------------------------------------
+// Built-in Traits
+//----------------------------------------------------------------------------
+
+TEST_CASE("compact_optional<T*>","[traits]")
+{
+  auto value = 42;
+
+  SECTION("Null pointer is disengaged")
+  {
+    auto optional = bpstd::compact_optional<int*>();
+
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Non-null pointer is engaged")
+  {
+    auto optional = bpstd::compact_optional<int*>(&value);
+
+    REQUIRE( *optional.value() == 42 );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("compact_optional<std::unique_ptr<T>>","[traits]")
+{
+  SECTION("Default constructed is disengaged")
+  {
+    auto optional = bpstd::compact_optional<std::unique_ptr<int>>();
+
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Owning pointer is engaged")
+  {
+    auto optional = bpstd::compact_optional<std::unique_ptr<int>>( std::unique_ptr<int>(new int(42)) );
+
+    REQUIRE( *optional.value() == 42 );
+
+    SECTION("Assigning nullopt releases the pointer")
+    {
+      optional = bpstd::nullopt;
+
+      REQUIRE_FALSE( static_cast<bool>(optional) );
+    }
+
+    SECTION("Moving transfers ownership")
+    {
+      auto other = std::move(optional);
+
+      REQUIRE_FALSE( static_cast<bool>(optional) );
+      REQUIRE( *other.value() == 42 );
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("compact_optional<std::reference_wrapper<T>>","[traits]")
+{
+  auto value = 42;
+
+  SECTION("Default constructed is disengaged")
+  {
+    auto optional = bpstd::compact_optional<std::reference_wrapper<int>>();
+
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Bound reference is engaged")
+  {
+    auto optional = bpstd::compact_optional<std::reference_wrapper<int>>( std::ref(value) );
+
+    REQUIRE( &optional.value().get() == &value );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("compact_optional<double>","[traits]")
+{
+  using limits = std::numeric_limits<double>;
+
+  SECTION("Default constructed is disengaged")
+  {
+    auto optional = bpstd::compact_optional<double>();
+
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+    REQUIRE( optional.value_or(1.5) == 1.5 );
+  }
+
+  SECTION("Ordinary values are engaged")
+  {
+    auto optional = bpstd::compact_optional<double>(-0.0);
+
+    REQUIRE( static_cast<bool>(optional) );
+    REQUIRE( optional.value_or(1.5) == 0.0 );
+  }
+
+  SECTION("Quiet NaN is engaged")
+  {
+    auto optional = bpstd::compact_optional<double>(limits::quiet_NaN());
+
+    REQUIRE( static_cast<bool>(optional) );
+    REQUIRE( optional.value() != optional.value() );
+    REQUIRE( optional.value_or(1.5) != optional.value_or(1.5) );
+  }
+
+  SECTION("Signaling NaN is engaged")
+  {
+    auto optional = bpstd::compact_optional<double>(limits::signaling_NaN());
+
+    REQUIRE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Computed NaN is engaged")
+  {
+    volatile auto zero = 0.0;
+    auto optional = bpstd::compact_optional<double>(zero / zero);
+
+    REQUIRE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Infinity is engaged")
+  {
+    auto optional = bpstd::compact_optional<double>(-limits::infinity());
+
+    REQUIRE( static_cast<bool>(optional) );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("compact_optional<float>","[traits]")
+{
+  using limits = std::numeric_limits<float>;
+
+  SECTION("Default constructed is disengaged")
+  {
+    auto optional = bpstd::compact_optional<float>();
+
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+    REQUIRE( optional.value_or(1.5f) == 1.5f );
+    REQUIRE( std::move(optional).value_or(1.5f) == 1.5f );
+  }
+
+  SECTION("Quiet NaN is engaged")
+  {
+    auto optional = bpstd::compact_optional<float>(limits::quiet_NaN());
+
+    REQUIRE( static_cast<bool>(optional) );
+    REQUIRE( optional.value_or(1.5f) != optional.value_or(1.5f) );
+  }
+
+  SECTION("Signaling NaN is engaged")
+  {
+    auto optional = bpstd::compact_optional<float>(limits::signaling_NaN());
+
+    REQUIRE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Assigning nullopt disengages")
+  {
+    auto optional = bpstd::compact_optional<float>(2.0f);
+    optional = bpstd::nullopt;
+
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+}
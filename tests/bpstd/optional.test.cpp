@@ -10,6 +10,12 @@
 
 #include "../catch.hpp"
 
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 class CtorTest
 {
 public:
@@ -108,6 +114,185 @@ private:
   bool& m_is_called;
 };
 
+class ExplicitInt
+{
+public:
+  explicit ExplicitInt( int value ) : value(value){}
+
+  int value;
+};
+
+struct Base
+{
+  virtual ~Base() = default;
+};
+
+struct Derived : Base{};
+
+template<bool NothrowMove>
+class CopyCounter
+{
+public:
+  explicit CopyCounter( int& copies )
+    : m_copies(&copies)
+  {
+
+  }
+  CopyCounter( const CopyCounter& other )
+    : m_copies(other.m_copies)
+  {
+    ++(*m_copies);
+  }
+  CopyCounter( CopyCounter&& other ) noexcept(NothrowMove)
+    : m_copies(other.m_copies)
+  {
+
+  }
+private:
+  int* m_copies;
+};
+
+class ThrowingMoveOnly
+{
+public:
+  explicit ThrowingMoveOnly( int value )
+    : value(value)
+  {
+
+  }
+  ThrowingMoveOnly( ThrowingMoveOnly&& other ) noexcept(false)
+    : value(other.value)
+  {
+
+  }
+  ThrowingMoveOnly& operator=( ThrowingMoveOnly&& other ) noexcept(false)
+  {
+    value = other.value;
+    return (*this);
+  }
+
+  int value;
+};
+
+//----------------------------------------------------------------------------
+// Special Members
+//----------------------------------------------------------------------------
+
+static_assert( std::is_trivially_copy_constructible<bpstd::optional<int>>::value,
+               "optional<int> must be trivially copy-constructible" );
+static_assert( std::is_trivially_move_constructible<bpstd::optional<int>>::value,
+               "optional<int> must be trivially move-constructible" );
+static_assert( std::is_trivially_copy_assignable<bpstd::optional<int>>::value,
+               "optional<int> must be trivially copy-assignable" );
+static_assert( std::is_trivially_move_assignable<bpstd::optional<int>>::value,
+               "optional<int> must be trivially move-assignable" );
+static_assert( std::is_trivially_copyable<bpstd::optional<int>>::value,
+               "optional<int> must be trivially copyable" );
+static_assert( std::is_trivially_copyable<bpstd::optional<double>>::value,
+               "optional<double> must be trivially copyable" );
+
+static_assert( std::is_trivially_destructible<bpstd::optional<int>>::value,
+               "optional<int> must be trivially destructible" );
+// A constexpr object may only be of a literal type
+constexpr auto literal_optional = bpstd::optional<int>(42);
+static_assert( *literal_optional == 42,
+               "optional<int> must be a literal type" );
+
+static_assert( !std::is_trivially_copy_constructible<bpstd::optional<std::string>>::value,
+               "optional<std::string> must not be trivially copy-constructible" );
+static_assert( !std::is_trivially_copyable<bpstd::optional<std::string>>::value,
+               "optional<std::string> must not be trivially copyable" );
+static_assert( !std::is_trivially_destructible<bpstd::optional<std::string>>::value,
+               "optional<std::string> must not be trivially destructible" );
+
+static_assert( !std::is_copy_constructible<bpstd::optional<std::unique_ptr<int>>>::value,
+               "optional<T> must not be copy-constructible if T is not" );
+static_assert( !std::is_copy_assignable<bpstd::optional<std::unique_ptr<int>>>::value,
+               "optional<T> must not be copy-assignable if T is not" );
+static_assert( std::is_move_constructible<bpstd::optional<std::unique_ptr<int>>>::value,
+               "optional<std::unique_ptr<int>> must be move-constructible" );
+static_assert( std::is_move_assignable<bpstd::optional<std::unique_ptr<int>>>::value,
+               "optional<std::unique_ptr<int>> must be move-assignable" );
+static_assert( !std::is_copy_assignable<bpstd::optional<const std::string>>::value,
+               "optional<T> must not be copy-assignable if T is not" );
+static_assert( !std::is_move_assignable<bpstd::optional<const std::string>>::value,
+               "optional<T> must not be move-assignable if T is not" );
+
+static_assert( std::is_nothrow_move_constructible<bpstd::optional<std::string>>::value,
+               "optional<std::string> must be nothrow move-constructible" );
+static_assert( std::is_nothrow_move_assignable<bpstd::optional<std::string>>::value,
+               "optional<std::string> must be nothrow move-assignable" );
+static_assert( std::is_nothrow_default_constructible<bpstd::optional<std::string>>::value,
+               "optional() must be noexcept" );
+static_assert( !std::is_nothrow_copy_constructible<bpstd::optional<std::string>>::value,
+               "optional<std::string> copies may throw" );
+static_assert( !std::is_nothrow_move_constructible<bpstd::optional<CopyCounter<false>>>::value,
+               "optional<T> moves may throw if T's moves may throw" );
+static_assert( noexcept(std::declval<bpstd::optional<std::string>&>().swap(std::declval<bpstd::optional<std::string>&>())),
+               "optional<std::string>::swap must be noexcept" );
+static_assert( noexcept(swap(std::declval<bpstd::optional<std::string>&>(),std::declval<bpstd::optional<std::string>&>())),
+               "swap( optional<std::string>&, optional<std::string>& ) must be noexcept" );
+static_assert( noexcept(swap(std::declval<bpstd::optional<int&>&>(),std::declval<bpstd::optional<int&>&>())),
+               "swap( optional<T&>&, optional<T&>& ) must be noexcept" );
+static_assert( noexcept(std::declval<bpstd::optional<int>&>().emplace(42)),
+               "optional<int>::emplace( int ) must be noexcept" );
+static_assert( !noexcept(std::declval<bpstd::optional<std::string>&>().emplace("hello")),
+               "optional<std::string>::emplace( const char* ) may throw" );
+
+static_assert( std::is_convertible<const bpstd::optional<int>&,bpstd::optional<std::int64_t>>::value,
+               "optional<int> must implicitly convert to optional<std::int64_t>" );
+static_assert( std::is_convertible<bpstd::optional<const char*>&&,bpstd::optional<std::string>>::value,
+               "optional<const char*> must implicitly convert to optional<std::string>" );
+static_assert( std::is_constructible<bpstd::optional<ExplicitInt>,const bpstd::optional<int>&>::value,
+               "optional<ExplicitInt> must be constructible from optional<int>" );
+static_assert( !std::is_convertible<const bpstd::optional<int>&,bpstd::optional<ExplicitInt>>::value,
+               "optional<int> must only explicitly convert to optional<ExplicitInt>" );
+static_assert( !std::is_constructible<bpstd::optional<int>,const bpstd::optional<std::string>&>::value,
+               "optional<int> must not be constructible from optional<std::string>" );
+static_assert( !std::is_assignable<bpstd::optional<int>&,const bpstd::optional<std::string>&>::value,
+               "optional<int> must not be assignable from optional<std::string>" );
+
+TEST_CASE("optional<T> vector growth","[special]")
+{
+  SECTION("Moves elements if T's move is noexcept")
+  {
+    auto copies = 0;
+    auto values = std::vector<bpstd::optional<CopyCounter<true>>>();
+    for(auto i = 0; i < 100; ++i) {
+      values.emplace_back( bpstd::in_place, copies );
+    }
+
+    REQUIRE( copies == 0 );
+  }
+
+  SECTION("Copies elements if T's move may throw")
+  {
+    auto copies = 0;
+    auto values = std::vector<bpstd::optional<CopyCounter<false>>>();
+    for(auto i = 0; i < 100; ++i) {
+      values.emplace_back( bpstd::in_place, copies );
+    }
+
+    REQUIRE( copies > 0 );
+  }
+
+  SECTION("Moves elements if T is move-only and its move may throw")
+  {
+    auto values = std::vector<bpstd::optional<ThrowingMoveOnly>>();
+    for(auto i = 0; i < 100; ++i) {
+      values.emplace_back( bpstd::in_place, i );
+    }
+
+    REQUIRE( values.front()->value == 0 );
+    REQUIRE( values.back()->value == 99 );
+  }
+}
+
+namespace {
+  // Constant-initialized; requires no dynamic initialization or destruction
+  constexpr bpstd::optional<int> g_constant_optional{};
+} // namespace
+
 //----------------------------------------------------------------------------
 // Constructors / Destructor
 //----------------------------------------------------------------------------
@@ -240,6 +425,106 @@ TEST_CASE("optional::optional( value_type&& )","[ctor]")
 
 //----------------------------------------------------------------------------
 
+TEST_CASE("optional::optional( const optional<U>& )","[ctor]")
+{
+  SECTION("Converting a null optional")
+  {
+    const auto original = bpstd::optional<int>();
+    const bpstd::optional<std::int64_t> optional = original;
+
+    SECTION("Has no value")
+    {
+      REQUIRE_FALSE( static_cast<bool>(optional) );
+    }
+  }
+
+  SECTION("Converting a non-null optional")
+  {
+    const auto original = bpstd::optional<int>( 42 );
+    const bpstd::optional<std::int64_t> optional = original;
+
+    SECTION("Has a value")
+    {
+      REQUIRE( static_cast<bool>(optional) );
+    }
+
+    SECTION("Value is the converted original")
+    {
+      REQUIRE( optional.value() == 42 );
+    }
+  }
+
+  SECTION("Converting explicitly")
+  {
+    const auto original = bpstd::optional<int>( 42 );
+    const auto optional = bpstd::optional<ExplicitInt>( original );
+
+    REQUIRE( optional.value().value == 42 );
+  }
+
+  SECTION("Converting an optional reference")
+  {
+    const auto value = std::string("hello world");
+    const auto original = bpstd::optional<const std::string&>( value );
+    const bpstd::optional<std::string> optional = original;
+
+    REQUIRE( optional.value() == "hello world" );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional::optional( optional<U>&& )","[ctor]")
+{
+  SECTION("Converting a null optional")
+  {
+    auto original = bpstd::optional<std::unique_ptr<Derived>>();
+    bpstd::optional<std::unique_ptr<Base>> optional = std::move(original);
+
+    SECTION("Has no value")
+    {
+      REQUIRE_FALSE( static_cast<bool>(optional) );
+    }
+  }
+
+  SECTION("Converting a non-null optional")
+  {
+    auto* derived = new Derived();
+    auto original = bpstd::optional<std::unique_ptr<Derived>>( bpstd::in_place, derived );
+    bpstd::optional<std::unique_ptr<Base>> optional = std::move(original);
+
+    SECTION("Moves the value of the original")
+    {
+      REQUIRE( optional.value().get() == derived );
+      REQUIRE( original.value() == nullptr );
+    }
+  }
+
+  SECTION("Converting an optional reference")
+  {
+    auto value = std::string("hello world");
+    bpstd::optional<std::string> optional = bpstd::optional<std::string&>( value );
+
+    SECTION("Copies the referenced value")
+    {
+      REQUIRE( optional.value() == "hello world" );
+      REQUIRE( value == "hello world" );
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional::optional() for constant-initialized globals","[ctor]")
+{
+  SECTION("Has no value")
+  {
+    REQUIRE_FALSE( static_cast<bool>(g_constant_optional) );
+  }
+}
+
+//----------------------------------------------------------------------------
+
 TEST_CASE("optional::~optional()","[dtor]")
 {
   bool is_called = false;
@@ -278,6 +563,17 @@ TEST_CASE("optional::operator=( nullopt_t )","[assignment]")
     }
   }
 
+  SECTION("Assigning over non-null trivially destructible value")
+  {
+    auto optional = bpstd::optional<int>( 42 );
+    optional = bpstd::nullopt;
+
+    SECTION("Converts to null")
+    {
+      REQUIRE_FALSE( static_cast<bool>(optional) );
+    }
+  }
+
   SECTION("Assigning over null value")
   {
     auto optional = bpstd::optional<int>( bpstd::nullopt );
@@ -293,18 +589,230 @@ TEST_CASE("optional::operator=( nullopt_t )","[assignment]")
 
 TEST_CASE("optional::operator=( const optional& )","[assignment]")
 {
+  SECTION("Assigning non-null over null value")
+  {
+    auto original = bpstd::optional<std::string>("hello world");
+    auto optional = bpstd::optional<std::string>();
+    optional = original;
+
+    SECTION("Has a value")
+    {
+      REQUIRE( static_cast<bool>(optional) );
+    }
+
+    SECTION("Value is the same as original")
+    {
+      REQUIRE( optional.value() == original.value() );
+    }
+  }
+
+  SECTION("Assigning non-null over non-null value")
+  {
+    auto original = bpstd::optional<std::string>("hello world");
+    auto optional = bpstd::optional<std::string>("goodbye world");
+    optional = original;
+
+    SECTION("Value is the same as original")
+    {
+      REQUIRE( optional.value() == original.value() );
+    }
+  }
+
+  SECTION("Assigning null over non-null value")
+  {
+    auto original = bpstd::optional<std::string>();
+    auto optional = bpstd::optional<std::string>("goodbye world");
+    optional = original;
+
+    SECTION("Converts to null")
+    {
+      REQUIRE_FALSE( static_cast<bool>(optional) );
+    }
+  }
 }
 
 //----------------------------------------------------------------------------
 
 TEST_CASE("optional::operator=( optional&& )","[assignment]")
 {
+  SECTION("Assigning non-null over null value")
+  {
+    auto original = bpstd::optional<std::string>("hello world");
+    auto optional = bpstd::optional<std::string>();
+    optional = std::move(original);
+
+    SECTION("Has a value")
+    {
+      REQUIRE( static_cast<bool>(optional) );
+    }
+
+    SECTION("Value is moved from original")
+    {
+      REQUIRE( optional.value() == "hello world" );
+    }
+  }
+
+  SECTION("Assigning non-null over non-null value")
+  {
+    auto original = bpstd::optional<std::string>("hello world");
+    auto optional = bpstd::optional<std::string>("goodbye world");
+    optional = std::move(original);
+
+    SECTION("Value is moved from original")
+    {
+      REQUIRE( optional.value() == "hello world" );
+    }
+  }
+
+  SECTION("Assigning null over non-null value")
+  {
+    auto original = bpstd::optional<std::string>();
+    auto optional = bpstd::optional<std::string>("goodbye world");
+    optional = std::move(original);
+
+    SECTION("Converts to null")
+    {
+      REQUIRE_FALSE( static_cast<bool>(optional) );
+    }
+  }
 }
 
 //----------------------------------------------------------------------------
 
 TEST_CASE("optional::operator=( U&& )","[assignment]")
 {
+  SECTION("Assigning over null value")
+  {
+    auto optional = bpstd::optional<std::string>();
+    optional = "hello world";
+
+    SECTION("Constructs the value")
+    {
+      REQUIRE( optional.value() == "hello world" );
+    }
+  }
+
+  SECTION("Assigning over non-null value")
+  {
+    auto optional = bpstd::optional<std::string>( "goodbye" );
+    auto* data = &*optional;
+    optional = "hello world";
+
+    SECTION("Assigns to the existing value")
+    {
+      REQUIRE( &*optional == data );
+      REQUIRE( optional.value() == "hello world" );
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional::operator=( const optional<U>& )","[assignment]")
+{
+  SECTION("Assigning null over non-null value")
+  {
+    const auto original = bpstd::optional<int>();
+    auto optional = bpstd::optional<std::int64_t>( 42 );
+    optional = original;
+
+    SECTION("Converts to null")
+    {
+      REQUIRE_FALSE( static_cast<bool>(optional) );
+    }
+  }
+
+  SECTION("Assigning non-null over null value")
+  {
+    const auto original = bpstd::optional<int>( 42 );
+    auto optional = bpstd::optional<std::int64_t>();
+    optional = original;
+
+    SECTION("Contains the converted value")
+    {
+      REQUIRE( optional.value() == 42 );
+    }
+  }
+
+  SECTION("Assigning non-null over non-null value")
+  {
+    const auto original = bpstd::optional<const char*>( "hello world" );
+    auto optional = bpstd::optional<std::string>( "goodbye" );
+    optional = original;
+
+    SECTION("Contains the converted value")
+    {
+      REQUIRE( optional.value() == "hello world" );
+    }
+  }
+
+  SECTION("Assigning an optional reference")
+  {
+    const auto value = std::string("hello world");
+    const auto original = bpstd::optional<const std::string&>( value );
+    auto optional = bpstd::optional<std::string>( "goodbye" );
+    optional = original;
+
+    REQUIRE( optional.value() == "hello world" );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional::operator=( optional<U>&& )","[assignment]")
+{
+  SECTION("Assigning an optional reference")
+  {
+    auto value = std::string("hello world");
+    auto optional = bpstd::optional<std::string>();
+    optional = bpstd::optional<std::string&>( value );
+
+    SECTION("Copies the referenced value")
+    {
+      REQUIRE( optional.value() == "hello world" );
+      REQUIRE( value == "hello world" );
+    }
+  }
+
+  SECTION("Assigning null over non-null value")
+  {
+    auto original = bpstd::optional<std::unique_ptr<Derived>>();
+    auto optional = bpstd::optional<std::unique_ptr<Base>>( bpstd::in_place, new Derived() );
+    optional = std::move(original);
+
+    SECTION("Converts to null")
+    {
+      REQUIRE_FALSE( static_cast<bool>(optional) );
+    }
+  }
+
+  SECTION("Assigning non-null over null value")
+  {
+    auto* derived = new Derived();
+    auto original = bpstd::optional<std::unique_ptr<Derived>>( bpstd::in_place, derived );
+    auto optional = bpstd::optional<std::unique_ptr<Base>>();
+    optional = std::move(original);
+
+    SECTION("Moves the value of the original")
+    {
+      REQUIRE( optional.value().get() == derived );
+      REQUIRE( original.value() == nullptr );
+    }
+  }
+
+  SECTION("Assigning non-null over non-null value")
+  {
+    auto* derived = new Derived();
+    auto original = bpstd::optional<std::unique_ptr<Derived>>( bpstd::in_place, derived );
+    auto optional = bpstd::optional<std::unique_ptr<Base>>( bpstd::in_place, new Derived() );
+    optional = std::move(original);
+
+    SECTION("Moves the value of the original")
+    {
+      REQUIRE( optional.value().get() == derived );
+      REQUIRE( original.value() == nullptr );
+    }
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -377,11 +885,42 @@ TEST_CASE("optional::value() const &&","[observers]")
 
 //----------------------------------------------------------------------------
 
-TEST_CASE("optional::value_or( U&& ) const &","[observers]")
+TEST_CASE("optional::unchecked_value() &","[observers]")
 {
-  SECTION("Optional is null")
+  auto optional = bpstd::optional<std::string>("hello world");
+
+  SECTION("Returns a reference to the contained value")
   {
-    auto optional = bpstd::optional<int>();
+    REQUIRE( &optional.unchecked_value() == &*optional );
+  }
+
+  SECTION("Is noexcept")
+  {
+    static_assert( noexcept(optional.unchecked_value()),
+                   "unchecked_value() must not throw" );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional::unchecked_value() &&","[observers]")
+{
+  auto optional = bpstd::optional<std::string>("hello world");
+  auto value = std::move(optional).unchecked_value();
+
+  SECTION("Moves the contained value")
+  {
+    REQUIRE( value == "hello world" );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional::value_or( U&& ) const &","[observers]")
+{
+  SECTION("Optional is null")
+  {
+    auto optional = bpstd::optional<int>();
 
     REQUIRE( optional.value_or(42) == 42 );
   }
@@ -411,12 +950,327 @@ TEST_CASE("optional::value_or( U&& ) &&","[observers]")
 
     REQUIRE( std::move(optional).value_or(42) == 32 );
   }
+
+  SECTION("Value is moved out of the optional")
+  {
+    auto optional = bpstd::optional<std::string>("hello world");
+    auto value    = std::move(optional).value_or("goodbye");
+
+    REQUIRE( value == "hello world" );
+    REQUIRE( static_cast<bool>(optional) );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional::value_or_else( F&& ) const &","[observers]")
+{
+  auto calls    = 0;
+  auto fallback = [&calls]{ ++calls; return std::string("goodbye"); };
+
+  SECTION("Optional is null")
+  {
+    auto optional = bpstd::optional<std::string>();
+
+    REQUIRE( optional.value_or_else(fallback) == "goodbye" );
+    REQUIRE( calls == 1 );
+  }
+
+  SECTION("Optional is non-null")
+  {
+    auto optional = bpstd::optional<std::string>("hello world");
+
+    SECTION("Returns the value")
+    {
+      REQUIRE( optional.value_or_else(fallback) == "hello world" );
+    }
+
+    SECTION("Does not invoke the function")
+    {
+      optional.value_or_else(fallback);
+
+      REQUIRE( calls == 0 );
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional::value_or_else( F&& ) &&","[observers]")
+{
+  auto calls    = 0;
+  auto fallback = [&calls]{ ++calls; return std::string("goodbye"); };
+
+  SECTION("Optional is null")
+  {
+    auto optional = bpstd::optional<std::string>();
+
+    REQUIRE( std::move(optional).value_or_else(fallback) == "goodbye" );
+  }
+
+  SECTION("Optional is non-null")
+  {
+    auto optional = bpstd::optional<std::string>("hello world");
+    auto value    = std::move(optional).value_or_else(fallback);
+
+    REQUIRE( value == "hello world" );
+    REQUIRE( static_cast<bool>(optional) );
+    REQUIRE( calls == 0 );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+  template<typename T, typename Arg, typename = void>
+  struct can_value_or_construct : std::false_type{};
+
+  template<typename T, typename Arg>
+  struct can_value_or_construct<T,Arg,decltype(void(
+    std::declval<const bpstd::optional<T>&>().value_or_construct(std::declval<Arg>())
+  ))> : std::true_type{};
+
+} // namespace
+
+static_assert( can_value_or_construct<std::string,const char*>::value,
+               "value_or_construct must construct from its arguments" );
+static_assert( !can_value_or_construct<int*,long>::value,
+               "value_or_construct must not cast an integer to a pointer" );
+static_assert( !can_value_or_construct<int*,const int*>::value,
+               "value_or_construct must not cast away const" );
+
+TEST_CASE("optional::value_or_construct( Args&&... ) const &","[observers]")
+{
+  SECTION("Optional is null")
+  {
+    auto optional = bpstd::optional<std::string>();
+
+    REQUIRE( optional.value_or_construct(3u,'x') == "xxx" );
+  }
+
+  SECTION("Optional is non-null")
+  {
+    auto optional = bpstd::optional<std::string>("hello world");
+
+    REQUIRE( optional.value_or_construct(3u,'x') == "hello world" );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional::value_or_construct( Args&&... ) &&","[observers]")
+{
+  SECTION("Optional is null")
+  {
+    auto optional = bpstd::optional<std::string>();
+
+    REQUIRE( std::move(optional).value_or_construct() == "" );
+  }
+
+  SECTION("Optional is non-null")
+  {
+    auto optional = bpstd::optional<std::string>("hello world");
+    auto value    = std::move(optional).value_or_construct(3u,'x');
+
+    REQUIRE( value == "hello world" );
+    REQUIRE( static_cast<bool>(optional) );
+  }
+}
+
+//----------------------------------------------------------------------------
+// Monadic Operations
+//----------------------------------------------------------------------------
+
+namespace {
+
+  bpstd::optional<int> parse_digit( const std::string& s )
+  {
+    return (s.size() == 1 && s[0] >= '0' && s[0] <= '9')
+      ? bpstd::optional<int>(s[0] - '0')
+      : bpstd::nullopt;
+  }
+
+} // namespace
+
+TEST_CASE("optional::and_then( F&& )","[monadic]")
+{
+  SECTION("Optional is null")
+  {
+    auto calls    = 0;
+    auto optional = bpstd::optional<std::string>();
+    auto result   = optional.and_then([&calls]( const std::string& s ){
+      ++calls;
+      return parse_digit(s);
+    });
+
+    REQUIRE_FALSE( static_cast<bool>(result) );
+    REQUIRE( calls == 0 );
+  }
+
+  SECTION("Optional is non-null")
+  {
+    auto optional = bpstd::optional<std::string>("4");
+
+    SECTION("Returns the result of the function")
+    {
+      REQUIRE( optional.and_then(parse_digit).value() == 4 );
+    }
+
+    SECTION("Propagates an empty result")
+    {
+      optional = std::string("x");
+
+      REQUIRE_FALSE( static_cast<bool>(optional.and_then(parse_digit)) );
+    }
+  }
+
+  SECTION("Rvalue optional passes an rvalue")
+  {
+    auto optional = bpstd::optional<std::string>("hello world");
+    auto result   = std::move(optional).and_then([]( std::string&& s ){
+      return bpstd::optional<std::string>( std::move(s) );
+    });
+
+    REQUIRE( result.value() == "hello world" );
+    REQUIRE( static_cast<bool>(optional) );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional::transform( F&& )","[monadic]")
+{
+  SECTION("Optional is null")
+  {
+    auto calls    = 0;
+    auto optional = bpstd::optional<int>();
+    auto result   = optional.transform([&calls]( int x ){
+      ++calls;
+      return std::to_string(x);
+    });
+
+    REQUIRE_FALSE( static_cast<bool>(result) );
+    REQUIRE( calls == 0 );
+  }
+
+  SECTION("Optional is non-null")
+  {
+    auto optional = bpstd::optional<int>(42);
+    auto result   = optional.transform([]( int x ){ return std::to_string(x); });
+
+    REQUIRE( result.value() == "42" );
+  }
+
+  SECTION("Rvalue optional passes an rvalue")
+  {
+    auto optional = bpstd::optional<std::string>("hello world");
+    auto result   = std::move(optional).transform([]( std::string&& s ){
+      return std::move(s) + "!";
+    });
+
+    REQUIRE( result.value() == "hello world!" );
+    REQUIRE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Stages chain")
+  {
+    auto result = bpstd::optional<std::string>("7")
+      .and_then(parse_digit)
+      .transform([]( int x ){ return x * 6; });
+
+    REQUIRE( result.value() == 42 );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional::or_else( F&& )","[monadic]")
+{
+  auto calls    = 0;
+  auto fallback = [&calls]{
+    ++calls;
+    return bpstd::optional<std::string>("goodbye");
+  };
+
+  SECTION("Optional is null")
+  {
+    auto optional = bpstd::optional<std::string>();
+
+    REQUIRE( optional.or_else(fallback).value() == "goodbye" );
+    REQUIRE( calls == 1 );
+  }
+
+  SECTION("Optional is non-null")
+  {
+    auto optional = bpstd::optional<std::string>("hello world");
+
+    REQUIRE( optional.or_else(fallback).value() == "hello world" );
+    REQUIRE( calls == 0 );
+  }
+
+  SECTION("Rvalue optional is moved")
+  {
+    auto optional = bpstd::optional<std::string>("hello world");
+    auto result   = std::move(optional).or_else(fallback);
+
+    REQUIRE( result.value() == "hello world" );
+    REQUIRE( static_cast<bool>(optional) );
+  }
 }
 
 //----------------------------------------------------------------------------
 // Modifiers
 //----------------------------------------------------------------------------
 
+TEST_CASE("optional::reset()","[modifiers]")
+{
+  SECTION("Original optional is null")
+  {
+    auto optional = bpstd::optional<int>();
+    optional.reset();
+
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Original optional contains a trivially destructible value")
+  {
+    auto optional = bpstd::optional<int>( 42 );
+    optional.reset();
+
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Original optional contains a value stored with a niche")
+  {
+    auto optional = bpstd::optional<bpstd::optional<int>>( bpstd::in_place, 42 );
+    optional.reset();
+
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Original optional contains a non-trivially destructible value")
+  {
+    auto is_called = false;
+    auto dtor = DtorTest(is_called);
+    auto optional = bpstd::optional<DtorTest>(dtor);
+    is_called = false;
+    optional.reset();
+
+    SECTION("Calls destructor on previous value")
+    {
+      REQUIRE( is_called );
+    }
+
+    SECTION("Converts to null")
+    {
+      REQUIRE_FALSE( static_cast<bool>(optional) );
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+
 TEST_CASE("optional::swap( optional<T>& )","[modifiers]")
 {
   SECTION("Both optionals are null")
@@ -464,41 +1318,835 @@ TEST_CASE("optional::swap( optional<T>& )","[modifiers]")
 
   SECTION("(*this) optional is null")
   {
+    auto op1 = bpstd::optional<std::string>();
+    auto op2 = bpstd::optional<std::string>("hello world");
+
+    op1.swap(op2);
+
+    SECTION("op1 contains op2's value")
+    {
+      REQUIRE( op1.value() == "hello world" );
+    }
 
+    SECTION("op2 is null")
+    {
+      REQUIRE_FALSE( static_cast<bool>(op2) );
+    }
   }
 
   SECTION("other optional is null")
   {
+    auto op1 = bpstd::optional<std::string>("hello world");
+    auto op2 = bpstd::optional<std::string>();
+
+    op1.swap(op2);
+
+    SECTION("op1 is null")
+    {
+      REQUIRE_FALSE( static_cast<bool>(op1) );
+    }
+
+    SECTION("op2 contains op1's value")
+    {
+      REQUIRE( op2.value() == "hello world" );
+    }
+  }
+
+  SECTION("Optionals contain move-only values")
+  {
+    auto op1 = bpstd::optional<std::unique_ptr<int>>( bpstd::in_place, new int(42) );
+    auto op2 = bpstd::optional<std::unique_ptr<int>>();
+
+    op1.swap(op2);
+
+    SECTION("op1 is null")
+    {
+      REQUIRE_FALSE( static_cast<bool>(op1) );
+    }
+
+    SECTION("op2 contains op1's value")
+    {
+      REQUIRE( *op2.value() == 42 );
+    }
+  }
+
+  SECTION("One optional contains a trivial value")
+  {
+    auto op1 = bpstd::optional<int>(42);
+    auto op2 = bpstd::optional<int>();
+
+    op1.swap(op2);
 
+    REQUIRE_FALSE( static_cast<bool>(op1) );
+    REQUIRE( op2.value() == 42 );
   }
 }
 
 //----------------------------------------------------------------------------
 
-TEST_CASE("optional::emplace( Args&&... )","[modifiers]")
+TEST_CASE("swap( optional<T>&, optional<T>& )","[modifiers]")
 {
-  SECTION("Original optional is null")
+  auto op1 = bpstd::optional<std::string>("hello world");
+  auto op2 = bpstd::optional<std::string>();
+
+  SECTION("Is found by argument-dependent lookup")
   {
+    using std::swap;
+    swap(op1,op2);
 
+    REQUIRE_FALSE( static_cast<bool>(op1) );
+    REQUIRE( op2.value() == "hello world" );
   }
 
-  SECTION("Original optional is non-null")
+  SECTION("Swaps move-only values")
+  {
+    auto op3 = bpstd::optional<std::unique_ptr<int>>( bpstd::in_place, new int(42) );
+    auto op4 = bpstd::optional<std::unique_ptr<int>>( bpstd::in_place, new int(64) );
+
+    using std::swap;
+    swap(op3,op4);
+
+    REQUIRE( *op3.value() == 64 );
+    REQUIRE( *op4.value() == 42 );
+  }
+
+  SECTION("Swaps optional references")
   {
+    auto a = 42;
+    auto op5 = bpstd::optional<int&>( a );
+    auto op6 = bpstd::optional<int&>();
 
+    using std::swap;
+    swap(op5,op6);
+
+    REQUIRE_FALSE( static_cast<bool>(op5) );
+    REQUIRE( &op6.value() == &a );
   }
 }
 
 //----------------------------------------------------------------------------
 
-TEST_CASE("optional::emplace( std::initializer_list<U>, Args&&... )","[modifiers]")
+TEST_CASE("optional::emplace( Args&&... )","[modifiers]")
 {
   SECTION("Original optional is null")
   {
+    auto optional = bpstd::optional<std::string>();
+    auto& value   = optional.emplace( 3u, 'x' );
 
-  }
+    SECTION("Has a value")
+    {
+      REQUIRE( static_cast<bool>(optional) );
+    }
+
+    SECTION("Returns a reference to the new value")
+    {
+      REQUIRE( &value == &*optional );
+      REQUIRE( value == "xxx" );
+    }
+  }
+
+  SECTION("Original optional is non-null")
+  {
+    auto optional = bpstd::optional<std::string>("hello world");
+    optional.emplace( 3u, 'x' );
+
+    SECTION("Replaces the value")
+    {
+      REQUIRE( optional.value() == "xxx" );
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional::emplace( std::initializer_list<U>, Args&&... )","[modifiers]")
+{
+  SECTION("Original optional is null")
+  {
+    auto optional = bpstd::optional<std::vector<int>>();
+    auto& value   = optional.emplace( {1,2,3} );
+
+    SECTION("Has a value")
+    {
+      REQUIRE( static_cast<bool>(optional) );
+    }
+
+    SECTION("Returns a reference to the new value")
+    {
+      REQUIRE( &value == &*optional );
+      REQUIRE(( value == std::vector<int>{1,2,3} ));
+    }
+  }
+
+  SECTION("Original optional is non-null")
+  {
+    auto optional = bpstd::optional<std::vector<int>>( bpstd::in_place, 5u, 0 );
+    optional.emplace( {1,2,3}, std::allocator<int>() );
+
+    SECTION("Replaces the value")
+    {
+      REQUIRE(( optional.value() == std::vector<int>{1,2,3} ));
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional::get_or_emplace( Args&&... )","[modifiers]")
+{
+  SECTION("Original optional is null")
+  {
+    auto optional = bpstd::optional<std::string>();
+    auto& value   = optional.get_or_emplace( 3u, 'x' );
+
+    SECTION("Constructs the value")
+    {
+      REQUIRE( optional.value() == "xxx" );
+    }
+
+    SECTION("Returns a reference to the value")
+    {
+      REQUIRE( &value == &*optional );
+    }
+  }
+
+  SECTION("Original optional is non-null")
+  {
+    auto optional = bpstd::optional<std::string>("hello world");
+    auto& value   = optional.get_or_emplace( 3u, 'x' );
+
+    SECTION("Keeps the value")
+    {
+      REQUIRE( value == "hello world" );
+    }
+
+    SECTION("Returns a reference to the value")
+    {
+      REQUIRE( &value == &*optional );
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional::get_or_emplace_with( F&& )","[modifiers]")
+{
+  auto calls   = 0;
+  auto factory = [&calls]{
+    ++calls;
+    return std::string("goodbye");
+  };
+
+  SECTION("Original optional is null")
+  {
+    auto optional = bpstd::optional<std::string>();
+    auto& value   = optional.get_or_emplace_with(factory);
+
+    REQUIRE( value == "goodbye" );
+    REQUIRE( &value == &*optional );
+    REQUIRE( calls == 1 );
+  }
+
+  SECTION("Original optional is non-null")
+  {
+    auto optional = bpstd::optional<std::string>("hello world");
+    auto& value   = optional.get_or_emplace_with(factory);
+
+    REQUIRE( value == "hello world" );
+    REQUIRE( calls == 0 );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional::take()","[modifiers]")
+{
+  SECTION("Original optional is null")
+  {
+    auto optional = bpstd::optional<std::string>();
+    auto result   = optional.take();
+
+    SECTION("Result is null")
+    {
+      REQUIRE_FALSE( static_cast<bool>(result) );
+    }
+
+    SECTION("Original optional remains null")
+    {
+      REQUIRE_FALSE( static_cast<bool>(optional) );
+    }
+  }
+
+  SECTION("Original optional is non-null")
+  {
+    auto optional = bpstd::optional<std::string>("hello world");
+    auto result   = optional.take();
+
+    SECTION("Result contains the previous value")
+    {
+      REQUIRE( result.value() == "hello world" );
+    }
+
+    SECTION("Original optional is null")
+    {
+      REQUIRE_FALSE( static_cast<bool>(optional) );
+    }
+  }
+
+  SECTION("Original optional contains a trivial value")
+  {
+    auto optional = bpstd::optional<int>(42);
+    auto result   = optional.take();
+
+    REQUIRE( result.value() == 42 );
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional::replace( U&& )","[modifiers]")
+{
+  SECTION("Original optional is null")
+  {
+    auto optional = bpstd::optional<std::string>();
+    auto result   = optional.replace("goodbye");
+
+    SECTION("Result is null")
+    {
+      REQUIRE_FALSE( static_cast<bool>(result) );
+    }
+
+    SECTION("Original optional contains the new value")
+    {
+      REQUIRE( optional.value() == "goodbye" );
+    }
+  }
 
   SECTION("Original optional is non-null")
   {
+    auto optional = bpstd::optional<std::string>("hello world");
+    auto result   = optional.replace("goodbye");
+
+    SECTION("Result contains the previous value")
+    {
+      REQUIRE( result.value() == "hello world" );
+    }
+
+    SECTION("Original optional contains the new value")
+    {
+      REQUIRE( optional.value() == "goodbye" );
+    }
+  }
+
+  SECTION("New value refers to the contained value")
+  {
+    const auto previous = std::string(40u, 'x');
+
+    SECTION("Copies the contained value")
+    {
+      auto optional = bpstd::optional<std::string>(previous);
+      auto result   = optional.replace(*optional);
+
+      REQUIRE( result.value() == previous );
+      REQUIRE( optional.value() == previous );
+    }
+
+    SECTION("Moves from the contained value")
+    {
+      auto optional = bpstd::optional<std::string>(previous);
+      auto result   = optional.replace(std::move(*optional));
+
+      REQUIRE( static_cast<bool>(result) );
+      REQUIRE( optional.value() == previous );
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// References
+//----------------------------------------------------------------------------
+
+static_assert( sizeof(bpstd::optional<std::string&>) == sizeof(std::string*),
+               "optional<T&> must be the size of a pointer" );
+static_assert( std::is_trivially_copyable<bpstd::optional<std::string&>>::value,
+               "optional<T&> must be trivially copyable" );
+static_assert( !std::is_constructible<bpstd::optional<const int&>,int&&>::value,
+               "optional<T&> must not bind to temporaries" );
+
+TEST_CASE("optional<T&>::optional()","[reference]")
+{
+  auto optional = bpstd::optional<int&>();
+
+  SECTION("Has no value")
+  {
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+
+  SECTION("value() throws")
+  {
+    REQUIRE_THROWS_AS( optional.value(), const bpstd::bad_optional_access& );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional<T&>::optional( T& )","[reference]")
+{
+  auto value    = std::string("hello world");
+  auto optional = bpstd::optional<std::string&>(value);
+
+  SECTION("Has a value")
+  {
+    REQUIRE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Refers to the original object")
+  {
+    REQUIRE( &optional.value() == &value );
+    REQUIRE( &*optional == &value );
+    REQUIRE( optional->size() == value.size() );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional<T&>::operator=( const optional& )","[reference]")
+{
+  auto value1   = 42;
+  auto value2   = 64;
+  auto optional = bpstd::optional<int&>(value1);
+
+  optional = bpstd::optional<int&>(value2);
+
+  SECTION("Rebinds the reference")
+  {
+    REQUIRE( &optional.value() == &value2 );
+  }
+
+  SECTION("Does not assign through the reference")
+  {
+    REQUIRE( value1 == 42 );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional<T&>::unchecked_value()","[reference]")
+{
+  auto value = 42;
+  auto optional = bpstd::optional<int&>( value );
+
+  REQUIRE( &optional.unchecked_value() == &value );
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional<T&>::value_or( T& )","[reference]")
+{
+  auto value    = 42;
+  auto fallback = 64;
+
+  SECTION("Optional is null")
+  {
+    auto optional = bpstd::optional<int&>();
+
+    REQUIRE( &optional.value_or(fallback) == &fallback );
+  }
+
+  SECTION("Optional is non-null")
+  {
+    auto optional = bpstd::optional<int&>(value);
+
+    REQUIRE( &optional.value_or(fallback) == &value );
+  }
+}
+
+//----------------------------------------------------------------------------
+// Empty Types
+//----------------------------------------------------------------------------
+
+namespace {
+
+  struct empty_tag
+  {
+    empty_tag() = default;
+    explicit empty_tag( int& constructions ){ ++constructions; }
+
+    int id() const { return 42; }
+  };
+
+  struct final_empty_tag final {};
+
+} // namespace
+
+static_assert( sizeof(bpstd::optional<empty_tag>) == 1,
+               "optional of an empty type must only store the engaged flag" );
+static_assert( std::is_trivially_copyable<bpstd::optional<empty_tag>>::value,
+               "optional of a trivially copyable empty type must be trivially copyable" );
+static_assert( sizeof(bpstd::optional<final_empty_tag>) == 2,
+               "optional of a final empty type stores the value separately" );
+
+TEST_CASE("optional<Empty>","[empty]")
+{
+  SECTION("Default constructed has no value")
+  {
+    auto optional = bpstd::optional<empty_tag>();
+
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Constructed in-place")
+  {
+    auto constructions = 0;
+    auto optional = bpstd::optional<empty_tag>( bpstd::in_place, constructions );
+
+    SECTION("Has a value")
+    {
+      REQUIRE( static_cast<bool>(optional) );
+    }
+
+    SECTION("Runs the constructor once")
+    {
+      REQUIRE( constructions == 1 );
+    }
+
+    SECTION("Value is accessible")
+    {
+      REQUIRE( optional->id() == 42 );
+    }
+  }
+
+  SECTION("Emplacing runs the constructor")
+  {
+    auto constructions = 0;
+    auto optional = bpstd::optional<empty_tag>();
+    optional.emplace( constructions );
+
+    REQUIRE( static_cast<bool>(optional) );
+    REQUIRE( constructions == 1 );
+  }
+}
+
+//----------------------------------------------------------------------------
+// Booleans
+//----------------------------------------------------------------------------
+
+static_assert( sizeof(bpstd::optional<bool>) == 2,
+               "optional<bool> must only add a flag byte" );
+static_assert( std::is_trivially_copyable<bpstd::optional<bool>>::value,
+               "optional<bool> must be trivially copyable" );
+
+TEST_CASE("optional<bool>","[bool]")
+{
+  SECTION("Default constructed has no value")
+  {
+    auto optional = bpstd::optional<bool>();
+
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Holding false has a value")
+  {
+    auto optional = bpstd::optional<bool>(false);
+
+    REQUIRE( static_cast<bool>(optional) );
+    REQUIRE_FALSE( optional.value() );
+  }
+
+  SECTION("Holding true has a value")
+  {
+    auto optional = bpstd::optional<bool>(true);
+
+    REQUIRE( static_cast<bool>(optional) );
+    REQUIRE( optional.value() );
+  }
+
+  SECTION("Assigning a value engages the optional")
+  {
+    auto optional = bpstd::optional<bool>();
+    optional = false;
+
+    REQUIRE( static_cast<bool>(optional) );
+    REQUIRE_FALSE( *optional );
+  }
+
+  SECTION("Copying preserves the state")
+  {
+    auto empty  = bpstd::optional<bool>();
+    auto filled = bpstd::optional<bool>(true);
+
+    auto empty_copy  = empty;
+    auto filled_copy = filled;
+
+    REQUIRE_FALSE( static_cast<bool>(empty_copy) );
+    REQUIRE( filled_copy.value() );
+  }
+}
+
+namespace {
+
+  constexpr auto g_tribool = bpstd::tribool(bpstd::to_compact_bool(true));
+
+} // namespace
+
+static_assert( sizeof(bpstd::tribool) == 1,
+               "tribool must encode its empty state in the value byte" );
+static_assert( !bpstd::tribool(),
+               "tribool must be disengaged in a constant expression" );
+static_assert( bpstd::to_bool(g_tribool.value()),
+               "tribool must be usable in a constant expression" );
+
+TEST_CASE("tribool","[bool]")
+{
+  SECTION("Default constructed has no value")
+  {
+    auto tribool = bpstd::tribool();
+
+    REQUIRE_FALSE( static_cast<bool>(tribool) );
+  }
+
+  SECTION("Holding false has a value")
+  {
+    auto tribool = bpstd::tribool(bpstd::to_compact_bool(false));
+
+    REQUIRE( static_cast<bool>(tribool) );
+    REQUIRE_FALSE( bpstd::to_bool(tribool.value()) );
+  }
+
+  SECTION("Holding true has a value")
+  {
+    auto tribool = bpstd::tribool(bpstd::to_compact_bool(true));
+
+    REQUIRE( static_cast<bool>(tribool) );
+    REQUIRE( bpstd::to_bool(tribool.value()) );
+  }
+
+  SECTION("Resetting disengages the tribool")
+  {
+    auto tribool = bpstd::tribool(bpstd::compact_bool::true_value);
+    tribool.reset();
+
+    REQUIRE_FALSE( static_cast<bool>(tribool) );
+  }
+
+  SECTION("Arrays use one byte per element")
+  {
+    bpstd::tribool flags[16] = {};
+    flags[3] = bpstd::compact_bool::false_value;
+
+    REQUIRE( sizeof(flags) == 16u );
+    REQUIRE_FALSE( static_cast<bool>(flags[0]) );
+    REQUIRE( flags[3].value() == bpstd::compact_bool::false_value );
+  }
+}
+
+//----------------------------------------------------------------------------
+// Enumerations
+//----------------------------------------------------------------------------
+
+namespace {
+
+  enum class color : unsigned char { red, green, blue };
+
+} // namespace
+
+namespace bpstd {
+  template<>
+  struct optional_sentinel_traits<color>
+    : value_sentinel_traits<color,static_cast<color>(0xff)>{};
+} // namespace bpstd
+
+namespace {
+
+  constexpr auto g_color = bpstd::optional<color>(color::red);
+
+} // namespace
+
+static_assert( sizeof(bpstd::optional<color>) == sizeof(color),
+               "optional of an enum with a sentinel must not store a flag" );
+static_assert( std::is_trivially_copyable<bpstd::optional<color>>::value,
+               "optional of an enum must be trivially copyable" );
+static_assert( !bpstd::optional<color>(),
+               "optional of an enum must be disengaged in a constant expression" );
+static_assert( g_color.value() == color::red,
+               "optional of an enum must be usable in a constant expression" );
+
+TEST_CASE("optional<Enum>","[enum]")
+{
+  SECTION("Default constructed has no value")
+  {
+    auto optional = bpstd::optional<color>();
+
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Holding the zero enumerator has a value")
+  {
+    auto optional = bpstd::optional<color>(color::red);
+
+    REQUIRE( static_cast<bool>(optional) );
+    REQUIRE( optional.value() == color::red );
+  }
+
+  SECTION("Emplacing engages the optional")
+  {
+    auto optional = bpstd::optional<color>();
+    optional.emplace( color::blue );
+
+    REQUIRE( optional.value() == color::blue );
+  }
+}
+
+//----------------------------------------------------------------------------
+// Nested Optionals
+//----------------------------------------------------------------------------
+
+static_assert( sizeof(bpstd::optional<bpstd::optional<std::int64_t>>) ==
+               sizeof(bpstd::optional<std::int64_t>),
+               "optional<optional<T>> must reuse the inner flag byte" );
+static_assert( sizeof(bpstd::optional<bpstd::optional<bpstd::optional<int>>>) ==
+               sizeof(bpstd::optional<int>),
+               "each level of nesting must reuse the inner flag byte" );
+static_assert( sizeof(bpstd::optional<bpstd::optional<bool>>) ==
+               sizeof(bpstd::optional<bool>),
+               "optional<optional<bool>> must reuse the inner flag byte" );
+static_assert( sizeof(bpstd::optional<bpstd::optional<empty_tag>>) == 1,
+               "optional<optional<Empty>> must be a single byte" );
+static_assert( std::is_trivially_copyable<bpstd::optional<bpstd::optional<int>>>::value,
+               "optional<optional<T>> must be trivially copyable if T is" );
+
+TEST_CASE("optional<optional<T>>","[nested]")
+{
+  using nested = bpstd::optional<bpstd::optional<int>>;
+
+  SECTION("Default constructed has no value")
+  {
+    auto optional = nested();
+
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Holding an empty optional has a value")
+  {
+    auto optional = nested( bpstd::in_place, bpstd::nullopt );
+
+    REQUIRE( static_cast<bool>(optional) );
+    REQUIRE_FALSE( static_cast<bool>(*optional) );
+  }
+
+  SECTION("Holding a filled optional has a value")
+  {
+    auto optional = nested( bpstd::optional<int>(42) );
+
+    REQUIRE( static_cast<bool>(optional) );
+    REQUIRE( optional->value() == 42 );
+  }
+
+  SECTION("Filling the inner optional keeps the outer engaged")
+  {
+    auto optional = nested( bpstd::in_place );
+    optional->emplace( 42 );
+
+    REQUIRE( static_cast<bool>(optional) );
+    REQUIRE( optional.value().value() == 42 );
+  }
+
+  SECTION("Three levels keep their states apart")
+  {
+    using triple = bpstd::optional<nested>;
 
+    auto empty       = triple();
+    auto empty_outer = triple( bpstd::in_place );
+    auto empty_inner = triple( bpstd::in_place, bpstd::in_place );
+
+    REQUIRE_FALSE( static_cast<bool>(empty) );
+    REQUIRE_FALSE( static_cast<bool>(*empty_outer) );
+    REQUIRE_FALSE( static_cast<bool>(**empty_inner) );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional<optional<std::string>>","[nested]")
+{
+  using nested = bpstd::optional<bpstd::optional<std::string>>;
+
+  SECTION("Copying preserves both levels")
+  {
+    auto original = nested( bpstd::optional<std::string>("hello world") );
+    auto optional = original;
+
+    REQUIRE( optional.value().value() == "hello world" );
+  }
+
+  SECTION("Resetting the outer optional destroys the inner value")
+  {
+    auto optional = nested( bpstd::optional<std::string>("hello world") );
+    optional = bpstd::nullopt;
+
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Resetting the inner optional keeps the outer engaged")
+  {
+    auto optional = nested( bpstd::optional<std::string>("hello world") );
+    *optional = bpstd::nullopt;
+
+    REQUIRE( static_cast<bool>(optional) );
+    REQUIRE_FALSE( static_cast<bool>(*optional) );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+  struct copy_throws
+  {
+    copy_throws() = default;
+    copy_throws( const copy_throws& ){ throw std::runtime_error("copy"); }
+    copy_throws& operator=( const copy_throws& ) = default;
+
+    int value = 0;
+  };
+
+} // namespace
+
+static_assert( sizeof(bpstd::optional<bpstd::optional<copy_throws>>) ==
+               sizeof(bpstd::optional<copy_throws>),
+               "optional<optional<T>> must reuse the inner flag byte" );
+
+TEST_CASE("optional<optional<T>> with a throwing copy","[nested]")
+{
+  using nested = bpstd::optional<bpstd::optional<copy_throws>>;
+
+  const auto inner = bpstd::optional<copy_throws>( bpstd::in_place );
+
+  SECTION("Emplacing a throwing copy leaves the optional empty")
+  {
+    auto optional = nested();
+
+    REQUIRE_THROWS_AS( optional.emplace( inner ), const std::runtime_error& );
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Assigning a throwing copy leaves the optional empty")
+  {
+    auto optional = nested();
+
+    REQUIRE_THROWS_AS( optional = inner, const std::runtime_error& );
+    REQUIRE_FALSE( static_cast<bool>(optional) );
+  }
+
+  SECTION("Empty optionals may still be engaged after a throwing copy")
+  {
+    auto optional = nested();
+    REQUIRE_THROWS_AS( optional.emplace( inner ), const std::runtime_error& );
+
+    optional.emplace( bpstd::nullopt );
+
+    REQUIRE( static_cast<bool>(optional) );
+    REQUIRE_FALSE( static_cast<bool>(*optional) );
   }
 }
@@ -0,0 +1,131 @@
+/**
+ * \file optional_constexpr.test.cpp
+ *
+ * \brief Compile-time unit tests for #bpstd::optional
+ */
+
+#include <bpstd/optional.hpp>
+
+#include "../catch.hpp"
+
+namespace {
+
+  struct literal_type
+  {
+    constexpr literal_type( int x, int y ) : x(x), y(y){}
+
+    int x;
+    int y;
+  };
+
+  /// \brief A constexpr lookup that would otherwise be built at startup
+  constexpr bpstd::optional<int> find_digit( char c )
+  {
+    return (c >= '0' && c <= '9')
+      ? bpstd::optional<int>(c - '0')
+      : bpstd::optional<int>(bpstd::nullopt);
+  }
+
+  constexpr int twice( int x ) { return x * 2; }
+
+  constexpr bpstd::optional<int> half( int x )
+  {
+    return (x % 2 == 0)
+      ? bpstd::optional<int>(x / 2)
+      : bpstd::optional<int>(bpstd::nullopt);
+  }
+
+  constexpr bpstd::optional<int> seven() { return bpstd::optional<int>(7); }
+
+  /// \brief Observes a prvalue optional through its constexpr const& overloads
+  constexpr int unwrap( const bpstd::optional<int>& optional )
+  {
+    return optional.value();
+  }
+
+  constexpr bpstd::optional<int> g_digits[] = {
+    find_digit('4'), find_digit('2'), find_digit('x'),
+  };
+
+} // namespace
+
+//----------------------------------------------------------------------------
+// Constructors
+//----------------------------------------------------------------------------
+
+static_assert( !bpstd::optional<int>(),
+               "optional() must be disengaged in a constant expression" );
+static_assert( !bpstd::optional<int>(bpstd::nullopt),
+               "optional( nullopt_t ) must be disengaged in a constant expression" );
+static_assert( static_cast<bool>(bpstd::optional<int>(42)),
+               "optional( value_type&& ) must be engaged in a constant expression" );
+static_assert( static_cast<bool>(bpstd::optional<literal_type>(bpstd::in_place,1,2)),
+               "optional( in_place_t, Args&&... ) must be engaged in a constant expression" );
+static_assert( !bpstd::optional<bool>(),
+               "optional<bool>() must be disengaged in a constant expression" );
+static_assert( static_cast<bool>(bpstd::optional<bool>(false)),
+               "optional<bool>( false ) must be engaged in a constant expression" );
+static_assert( !bpstd::optional<bpstd::optional<int>>(),
+               "optional<optional<T>>() must be disengaged in a constant expression" );
+static_assert( static_cast<bool>(bpstd::optional<bpstd::optional<int>>(bpstd::in_place,bpstd::nullopt)),
+               "optional<optional<T>> holding an empty optional must be engaged in a constant expression" );
+
+//----------------------------------------------------------------------------
+// Observers
+//----------------------------------------------------------------------------
+
+namespace {
+  constexpr auto g_value = 42;
+  constexpr auto g_optional = bpstd::optional<int>(g_value);
+  constexpr auto g_literal  = bpstd::optional<literal_type>(bpstd::in_place,1,2);
+  constexpr auto g_empty    = bpstd::optional<int>();
+  constexpr auto g_true     = bpstd::optional<bool>(true);
+  constexpr auto g_nested   = bpstd::optional<bpstd::optional<int>>(bpstd::optional<int>(42));
+} // namespace
+
+static_assert( *g_optional == g_value,
+               "operator*() const & must be usable in a constant expression" );
+static_assert( *static_cast<const bpstd::optional<int>&&>(g_optional) == g_value,
+               "operator*() const && must be usable in a constant expression" );
+static_assert( static_cast<bool>(g_true) && *g_true,
+               "optional<bool> must be usable in a constant expression" );
+static_assert( g_nested->value() == 42,
+               "optional<optional<T>> must be usable in a constant expression" );
+static_assert( g_literal->y == 2,
+               "operator->() const must be usable in a constant expression" );
+static_assert( g_optional.value() == g_value,
+               "value() const & must be usable in a constant expression" );
+static_assert( g_empty.value_or(7) == 7,
+               "value_or( U&& ) const & must be usable in a constant expression" );
+static_assert( g_optional.value_or(7) == g_value,
+               "value_or( U&& ) const & must be usable in a constant expression" );
+static_assert( g_empty.value_or_construct(7) == 7,
+               "value_or_construct( Args&&... ) const & must be usable in a constant expression" );
+
+static_assert( unwrap(g_optional.transform(twice)) == 2 * g_value,
+               "transform( F&& ) const & must be usable in a constant expression" );
+static_assert( unwrap(g_optional.and_then(half)) == g_value / 2,
+               "and_then( F&& ) const & must be usable in a constant expression" );
+static_assert( !g_empty.and_then(half),
+               "and_then( F&& ) const & must be usable in a constant expression" );
+static_assert( unwrap(g_empty.or_else(seven)) == 7,
+               "or_else( F&& ) const & must be usable in a constant expression" );
+static_assert( bpstd::optional<const int&>(g_value).value() == g_value,
+               "optional<T&> must be usable in a constant expression" );
+static_assert( bpstd::optional<const int&>().value_or(g_value) == g_value,
+               "optional<T&>::value_or( T& ) must be usable in a constant expression" );
+
+static_assert( g_digits[0].value() == 4 && g_digits[1].value() == 2 && !g_digits[2],
+               "optionals must be returnable from constexpr functions" );
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional constant expressions","[constexpr]")
+{
+  SECTION("Constant tables are usable at runtime")
+  {
+    REQUIRE( g_digits[0].value() == 4 );
+    REQUIRE( g_digits[1].value() == 2 );
+    REQUIRE_FALSE( static_cast<bool>(g_digits[2]) );
+  }
+}
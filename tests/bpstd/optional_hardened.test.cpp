@@ -0,0 +1,105 @@
+/**
+ * \file optional_hardened.test.cpp
+ *
+ * \brief Unit tests for #bpstd::optional with \c BPSTD_OPTIONAL_HARDENED
+ *        enabled in a release build
+ *
+ * This is built into a separate executable with \c NDEBUG defined and
+ * \c BPSTD_OPTIONAL_HARDENED explicitly enabled. The checks that abort the
+ * process are in optional_hardened_abort.test.cpp.
+ */
+
+#include <bpstd/optional.hpp>
+#include <bpstd/compact_optional.hpp>
+
+#if !defined(NDEBUG) || !BPSTD_OPTIONAL_HARDENED
+# error "optional_hardened.test.cpp must be built with NDEBUG and BPSTD_OPTIONAL_HARDENED=1"
+#endif
+
+#include "../catch.hpp"
+
+#include <string>
+
+//----------------------------------------------------------------------------
+// Observers
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional::operator*", "[observers]")
+{
+  SECTION("Optional contains a value")
+  {
+    auto optional = bpstd::optional<std::string>("hello world");
+
+    SECTION("Dereferences the value")
+    {
+      REQUIRE( *optional == "hello world" );
+    }
+
+    SECTION("Accesses members of the value")
+    {
+      REQUIRE( optional->size() == 11u );
+    }
+  }
+
+  SECTION("Optional contains a reference")
+  {
+    auto value = 42;
+    auto optional = bpstd::optional<int&>( value );
+
+    SECTION("Dereferences the referent")
+    {
+      REQUIRE( &*optional == &value );
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("compact_optional::operator*", "[observers]")
+{
+  SECTION("Optional contains a value")
+  {
+    auto value = 42;
+    auto optional = bpstd::compact_optional<int*>( &value );
+
+    SECTION("Dereferences the value")
+    {
+      REQUIRE( *optional == &value );
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("optional::unchecked_value()", "[observers]")
+{
+  auto optional = bpstd::optional<std::string>("hello world");
+
+  SECTION("Returns the contained value")
+  {
+    REQUIRE( optional.unchecked_value() == "hello world" );
+  }
+
+  SECTION("Refers to the same object as operator*")
+  {
+    REQUIRE( &optional.unchecked_value() == &*optional );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("compact_optional::unchecked_value()", "[observers]")
+{
+  auto value = 42;
+  auto optional = bpstd::compact_optional<int*>( &value );
+
+  SECTION("Returns the contained value")
+  {
+    REQUIRE( optional.unchecked_value() == &value );
+  }
+
+  SECTION("Refers to the same object as operator*")
+  {
+    REQUIRE( &optional.unchecked_value() == &*optional );
+  }
+}
@@ -0,0 +1,66 @@
+/**
+ * \file optional_hardened_abort.test.cpp
+ *
+ * \brief Checks that an empty #bpstd::optional aborts on access when
+ *        \c BPSTD_OPTIONAL_HARDENED is enabled in a release build
+ *
+ * This is built into a separate executable with \c NDEBUG defined and
+ * \c BPSTD_OPTIONAL_HARDENED explicitly enabled. It uses the standalone
+ * harness rather than Catch, since each check aborts the process.
+ *
+ * Usage: hardened_abort_tests (dereference_empty|dereference_empty_compact),
+ * where each argument dereferences an empty optional or compact_optional,
+ * and succeeds only if that aborts.
+ */
+
+#include <bpstd/optional.hpp>
+#include <bpstd/compact_optional.hpp>
+
+#if !defined(NDEBUG) || !BPSTD_OPTIONAL_HARDENED
+# error "optional_hardened_abort.test.cpp must be built with NDEBUG and BPSTD_OPTIONAL_HARDENED=1"
+#endif
+
+#include "../standalone_test.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+  int test_dereference_empty_optional_aborts()
+  {
+    standalone_test::expect_abort();
+
+    auto optional = bpstd::optional<int>();
+    volatile auto value = *optional;
+    (void) value;
+
+    return standalone_test::did_not_abort( "operator*()", __FILE__, __LINE__ );
+  }
+
+  int test_dereference_empty_compact_optional_aborts()
+  {
+    standalone_test::expect_abort();
+
+    auto optional = bpstd::compact_optional<int*>();
+    volatile auto value = *optional;
+    (void) value;
+
+    return standalone_test::did_not_abort( "operator*()", __FILE__, __LINE__ );
+  }
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+  if(argc > 1 && std::strcmp(argv[1],"dereference_empty") == 0) {
+    return test_dereference_empty_optional_aborts();
+  }
+  if(argc > 1 && std::strcmp(argv[1],"dereference_empty_compact") == 0) {
+    return test_dereference_empty_compact_optional_aborts();
+  }
+
+  std::printf( "usage: %s (dereference_empty|dereference_empty_compact)\n", argv[0] );
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,343 @@
+/**
+ * \file optional_instrumentation.test.cpp
+ *
+ * \brief Unit tests for the operation counters of #bpstd::optional
+ *
+ * This is built into a separate executable, with
+ * \c BPSTD_OPTIONAL_INSTRUMENTATION defined for every translation unit.
+ */
+
+#if !defined(BPSTD_OPTIONAL_INSTRUMENTATION)
+# error "optional_instrumentation.test.cpp requires BPSTD_OPTIONAL_INSTRUMENTATION"
+#endif
+
+#include <bpstd/optional.hpp>
+
+#include "../catch.hpp"
+
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace {
+
+  /// \brief A payload that is expensive to copy
+  struct payload
+  {
+    explicit payload( const char* text ) : text(text){}
+
+    std::string text;
+  };
+
+  bpstd::optional_counters reset_and_snapshot()
+  {
+    bpstd::reset_optional_counters<payload>();
+    return bpstd::optional_counters_snapshot<payload>();
+  }
+
+} // namespace
+
+//----------------------------------------------------------------------------
+// Constructors / Destructor
+//----------------------------------------------------------------------------
+
+TEST_CASE("instrumentation: construction and destruction","[instrumentation]")
+{
+  reset_and_snapshot();
+  {
+    auto optional = bpstd::optional<payload>( bpstd::in_place, "hello world" );
+    (void) optional;
+  }
+  auto counters = bpstd::optional_counters_snapshot<payload>();
+
+  SECTION("Counts one construction")
+  {
+    REQUIRE( counters.constructions == 1u );
+  }
+
+  SECTION("Counts one destruction")
+  {
+    REQUIRE( counters.destructions == 1u );
+  }
+
+  SECTION("Counts no copies or moves")
+  {
+    REQUIRE( counters.copies == 0u );
+    REQUIRE( counters.moves == 0u );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("instrumentation: construction from a value","[instrumentation]")
+{
+  const auto value = payload("hello world");
+
+  SECTION("Constructing from an lvalue counts a copy")
+  {
+    reset_and_snapshot();
+    auto optional = bpstd::optional<payload>( value );
+    (void) optional;
+
+    auto counters = bpstd::optional_counters_snapshot<payload>();
+    REQUIRE( counters.copies == 1u );
+    REQUIRE( counters.constructions == 0u );
+  }
+
+  SECTION("Constructing from an rvalue counts a move")
+  {
+    reset_and_snapshot();
+    auto optional = bpstd::optional<payload>( payload("hello world") );
+    (void) optional;
+
+    auto counters = bpstd::optional_counters_snapshot<payload>();
+    REQUIRE( counters.moves == 1u );
+    REQUIRE( counters.copies == 0u );
+    REQUIRE( counters.constructions == 0u );
+  }
+
+  SECTION("Assigning an lvalue to an empty optional counts a copy")
+  {
+    auto optional = bpstd::optional<payload>();
+    reset_and_snapshot();
+    optional = value;
+
+    auto counters = bpstd::optional_counters_snapshot<payload>();
+    REQUIRE( counters.copies == 1u );
+    REQUIRE( counters.constructions == 0u );
+  }
+
+  SECTION("Assigning an rvalue to an empty optional counts a move")
+  {
+    auto optional = bpstd::optional<payload>();
+    reset_and_snapshot();
+    optional = payload("hello world");
+
+    auto counters = bpstd::optional_counters_snapshot<payload>();
+    REQUIRE( counters.moves == 1u );
+    REQUIRE( counters.copies == 0u );
+    REQUIRE( counters.constructions == 0u );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("instrumentation: copy and move","[instrumentation]")
+{
+  auto original = bpstd::optional<payload>( bpstd::in_place, "hello world" );
+
+  SECTION("Copy construction counts a copy")
+  {
+    reset_and_snapshot();
+    auto copy = original;
+    (void) copy;
+
+    REQUIRE( bpstd::optional_counters_snapshot<payload>().copies == 1u );
+  }
+
+  SECTION("Move construction counts a move and no copies")
+  {
+    reset_and_snapshot();
+    auto moved = std::move(original);
+    (void) moved;
+
+    auto counters = bpstd::optional_counters_snapshot<payload>();
+    REQUIRE( counters.moves == 1u );
+    REQUIRE( counters.copies == 0u );
+  }
+
+  SECTION("Assigning over a value counts an assignment")
+  {
+    auto optional = bpstd::optional<payload>( bpstd::in_place, "goodbye" );
+    reset_and_snapshot();
+    optional = original;
+
+    auto counters = bpstd::optional_counters_snapshot<payload>();
+    REQUIRE( counters.assignments == 1u );
+    REQUIRE( counters.copies == 0u );
+  }
+
+  SECTION("Assigning nullopt counts a destruction")
+  {
+    reset_and_snapshot();
+    original = bpstd::nullopt;
+
+    REQUIRE( bpstd::optional_counters_snapshot<payload>().destructions == 1u );
+  }
+}
+
+//----------------------------------------------------------------------------
+// Modifiers
+//----------------------------------------------------------------------------
+
+TEST_CASE("instrumentation: take()","[instrumentation]")
+{
+  auto optional = bpstd::optional<payload>( bpstd::in_place, "hello world" );
+  reset_and_snapshot();
+
+  auto result = optional.take();
+  auto counters = bpstd::optional_counters_snapshot<payload>();
+
+  SECTION("Counts one destruction of the source")
+  {
+    REQUIRE( counters.destructions == 1u );
+  }
+
+  SECTION("Counts one move and no copies")
+  {
+    REQUIRE( counters.moves == 1u );
+    REQUIRE( counters.copies == 0u );
+  }
+
+  SECTION("Source is destroyed only once")
+  {
+    optional = bpstd::nullopt;
+
+    REQUIRE( bpstd::optional_counters_snapshot<payload>().destructions == 1u );
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("instrumentation: swap()","[instrumentation]")
+{
+  auto engaged = bpstd::optional<payload>( bpstd::in_place, "hello world" );
+  auto empty   = bpstd::optional<payload>();
+  reset_and_snapshot();
+
+  swap(engaged,empty);
+  auto counters = bpstd::optional_counters_snapshot<payload>();
+
+  SECTION("Counts one move and no copies")
+  {
+    REQUIRE( counters.moves == 1u );
+    REQUIRE( counters.copies == 0u );
+  }
+
+  SECTION("Counts one destruction of the moved-from value")
+  {
+    REQUIRE( counters.destructions == 1u );
+  }
+
+  SECTION("Leaves no value to destroy in the source")
+  {
+    engaged = bpstd::nullopt;
+
+    REQUIRE( bpstd::optional_counters_snapshot<payload>().destructions == 1u );
+  }
+}
+
+//----------------------------------------------------------------------------
+// Observers
+//----------------------------------------------------------------------------
+
+TEST_CASE("instrumentation: value()","[instrumentation]")
+{
+  auto optional = bpstd::optional<payload>();
+  reset_and_snapshot();
+
+  REQUIRE_THROWS_AS( optional.value(), const bpstd::bad_optional_access& );
+  REQUIRE( bpstd::optional_counters_snapshot<payload>().bad_accesses == 1u );
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("instrumentation: value_or( U&& ) const &","[instrumentation]")
+{
+  auto optional = bpstd::optional<payload>( bpstd::in_place, "hello world" );
+  reset_and_snapshot();
+
+  auto value = optional.value_or( payload("goodbye") );
+  (void) value;
+
+  REQUIRE( bpstd::optional_counters_snapshot<payload>().copies == 1u );
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("instrumentation: value_or( U&& ) &&","[instrumentation]")
+{
+  auto optional = bpstd::optional<payload>( bpstd::in_place, "hello world" );
+  reset_and_snapshot();
+
+  auto value = std::move(optional).value_or( payload("goodbye") );
+  (void) value;
+
+  auto counters = bpstd::optional_counters_snapshot<payload>();
+  REQUIRE( counters.moves == 1u );
+  REQUIRE( counters.copies == 0u );
+}
+
+//----------------------------------------------------------------------------
+
+TEST_CASE("instrumentation: value_or_else( F&& ) &&","[instrumentation]")
+{
+  auto optional = bpstd::optional<payload>( bpstd::in_place, "hello world" );
+  reset_and_snapshot();
+
+  auto value = std::move(optional).value_or_else([]{ return payload("goodbye"); });
+  (void) value;
+
+  auto counters = bpstd::optional_counters_snapshot<payload>();
+  REQUIRE( counters.moves == 1u );
+  REQUIRE( counters.copies == 0u );
+}
+
+TEST_CASE("instrumentation: transform( F&& ) &&","[instrumentation]")
+{
+  auto optional = bpstd::optional<std::string>( "hello world" );
+  reset_and_snapshot();
+
+  auto result = std::move(optional).transform([]( std::string&& text ){
+    return payload( text.c_str() );
+  });
+  (void) result;
+
+  auto counters = bpstd::optional_counters_snapshot<payload>();
+  REQUIRE( counters.constructions == 1u );
+  REQUIRE( counters.moves == 0u );
+  REQUIRE( counters.copies == 0u );
+}
+
+//----------------------------------------------------------------------------
+// Counters
+//----------------------------------------------------------------------------
+
+TEST_CASE("instrumentation: counters","[instrumentation]")
+{
+  SECTION("Counters are kept per type")
+  {
+    reset_and_snapshot();
+    bpstd::reset_optional_counters<int>();
+    auto optional = bpstd::optional<int>(bpstd::in_place, 42);
+    (void) optional;
+
+    REQUIRE( bpstd::optional_counters_snapshot<int>().constructions == 1u );
+    REQUIRE( bpstd::optional_counters_snapshot<payload>().constructions == 0u );
+  }
+
+  SECTION("Counters are kept per thread")
+  {
+    reset_and_snapshot();
+    auto other_constructions = std::size_t();
+
+    auto thread = std::thread([&]{
+      auto optional = bpstd::optional<payload>( bpstd::in_place, "hello world" );
+      (void) optional;
+      other_constructions = bpstd::optional_counters_snapshot<payload>().constructions;
+    });
+    thread.join();
+
+    REQUIRE( other_constructions == 1u );
+    REQUIRE( bpstd::optional_counters_snapshot<payload>().constructions == 0u );
+  }
+
+  SECTION("Resetting clears the counters")
+  {
+    auto optional = bpstd::optional<payload>( bpstd::in_place, "hello world" );
+    auto counters = reset_and_snapshot();
+    (void) optional;
+
+    REQUIRE( counters.constructions == 0u );
+  }
+}
@@ -0,0 +1,104 @@
+/**
+ * \file optional_no_exceptions.test.cpp
+ *
+ * \brief Unit tests for #bpstd::optional when built without exceptions
+ *
+ * This is built into a separate executable with exceptions disabled, so it
+ * uses the standalone harness rather than Catch.
+ *
+ * Usage: no_exceptions_tests [default_handler], where \c default_handler
+ * accesses an empty optional with no handler installed, and succeeds only
+ * if that aborts.
+ */
+
+#include <bpstd/optional.hpp>
+#include <bpstd/compact_optional.hpp>
+
+#if !defined(BPSTD_OPTIONAL_NO_EXCEPTIONS)
+# error "optional_no_exceptions.test.cpp must be built with exceptions disabled"
+#endif
+
+#include "../standalone_test.hpp"
+
+#include <csetjmp>
+#include <cstring>
+#include <string>
+
+namespace {
+
+  std::jmp_buf g_handler_return;
+  int g_handler_calls = 0;
+
+  /// \brief A handler that returns control to the check that invoked it
+  [[noreturn]] void recording_handler()
+  {
+    ++g_handler_calls;
+    std::longjmp( g_handler_return, 1 );
+  }
+
+  //--------------------------------------------------------------------------
+
+  void test_value_of_engaged_optional()
+  {
+    auto optional = bpstd::optional<std::string>("hello world");
+
+    CHECK( optional.value() == "hello world" );
+    CHECK( std::move(optional).value() == "hello world" );
+  }
+
+  void test_value_of_empty_optional_calls_handler()
+  {
+    const auto previous = bpstd::set_bad_optional_access_handler(&recording_handler);
+    CHECK( previous == nullptr );
+    CHECK( bpstd::get_bad_optional_access_handler() == &recording_handler );
+
+    g_handler_calls = 0;
+    if(setjmp(g_handler_return) == 0) {
+      auto optional = bpstd::optional<int>();
+      (void) optional.value();
+      CHECK( false && "value() returned from an empty optional" );
+    }
+    CHECK( g_handler_calls == 1 );
+
+    bpstd::set_bad_optional_access_handler(previous);
+  }
+
+  void test_value_of_empty_compact_optional_calls_handler()
+  {
+    const auto previous = bpstd::set_bad_optional_access_handler(&recording_handler);
+
+    g_handler_calls = 0;
+    if(setjmp(g_handler_return) == 0) {
+      auto optional = bpstd::compact_optional<int,bpstd::value_sentinel_traits<int,-1>>();
+      (void) optional.value();
+      CHECK( false && "value() returned from an empty compact_optional" );
+    }
+    CHECK( g_handler_calls == 1 );
+
+    bpstd::set_bad_optional_access_handler(previous);
+  }
+
+  int test_value_of_empty_optional_aborts_by_default()
+  {
+    standalone_test::expect_abort();
+
+    auto optional = bpstd::optional<int>();
+    (void) optional.value();
+
+    return standalone_test::did_not_abort( "value()", __FILE__, __LINE__ );
+  }
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+  if(argc > 1 && std::strcmp(argv[1],"default_handler") == 0) {
+    return test_value_of_empty_optional_aborts_by_default();
+  }
+
+  test_value_of_engaged_optional();
+  test_value_of_empty_optional_calls_handler();
+  test_value_of_empty_compact_optional_calls_handler();
+
+  return standalone_test::result();
+}
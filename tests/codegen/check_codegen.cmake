@@ -0,0 +1,91 @@
+# Checks that the probe functions of a codegen object contain no calls,
+# tail calls or stack accesses, that "probe_branchless_" functions contain
+# no conditional branches, and that "rodata_" objects are placed in
+# read-only data.
+#
+# Usage: cmake -DOBJDUMP=<objdump> -DOBJECT=<object file> -P check_codegen.cmake
+
+if(NOT OBJDUMP OR NOT OBJECT)
+  message(FATAL_ERROR "OBJDUMP and OBJECT must be defined")
+endif()
+
+execute_process(
+  COMMAND "${OBJDUMP}" -d -C --no-show-raw-insn "${OBJECT}"
+  OUTPUT_VARIABLE disassembly
+  RESULT_VARIABLE result
+)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "Unable to disassemble '${OBJECT}'")
+endif()
+
+# Protect list separators before splitting into lines
+string(REPLACE ";" "\;" disassembly "${disassembly}")
+string(REPLACE "\n" ";" lines "${disassembly}")
+
+set(function "")
+set(probes 0)
+set(failures "")
+foreach(line IN LISTS lines)
+  if(line MATCHES "^[0-9a-f]+ <(.*)>:$")
+    set(function "${CMAKE_MATCH_1}")
+    if(function MATCHES "probe_")
+      math(EXPR probes "${probes} + 1")
+    endif()
+  elseif(function MATCHES "probe_")
+    if(line MATCHES "[ \t](call|push)" OR line MATCHES "%[re]sp")
+      list(APPEND failures "${function}: ${line}")
+    elseif(line MATCHES "[ \t]jmp[ \t].*<(.*)>$")
+      # Jumps within the function are branches; anything else is a tail call
+      string(FIND "${CMAKE_MATCH_1}" "${function}" position)
+      if(NOT position EQUAL 0)
+        list(APPEND failures "${function}: ${line}")
+      endif()
+    elseif(function MATCHES "probe_branchless_" AND line MATCHES "[ \t]j[a-z]+[ \t]")
+      list(APPEND failures "${function}: ${line}")
+    endif()
+  endif()
+endforeach()
+
+if(probes EQUAL 0)
+  message(FATAL_ERROR "No probe functions found in '${OBJECT}'")
+endif()
+
+if(failures)
+  string(REPLACE ";" "\n  " failures "${failures}")
+  message(FATAL_ERROR "Probe functions call out, access the stack or branch:\n  ${failures}")
+endif()
+
+message(STATUS "${probes} probe functions are free of calls and stack accesses")
+
+execute_process(
+  COMMAND "${OBJDUMP}" -t -C "${OBJECT}"
+  OUTPUT_VARIABLE symbols
+  RESULT_VARIABLE result
+)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "Unable to read the symbols of '${OBJECT}'")
+endif()
+
+string(REPLACE ";" "\;" symbols "${symbols}")
+string(REPLACE "\n" ";" lines "${symbols}")
+
+set(objects 0)
+foreach(line IN LISTS lines)
+  if(line MATCHES "[ \t]([^ \t]+)[ \t]+[0-9a-f]+[ \t]+(.*rodata_.*)$")
+    math(EXPR objects "${objects} + 1")
+    if(NOT CMAKE_MATCH_1 MATCHES "^\\.rodata")
+      list(APPEND failures "${CMAKE_MATCH_2}: placed in ${CMAKE_MATCH_1}")
+    endif()
+  endif()
+endforeach()
+
+if(objects EQUAL 0)
+  message(FATAL_ERROR "No read-only objects found in '${OBJECT}'")
+endif()
+
+if(failures)
+  string(REPLACE ";" "\n  " failures "${failures}")
+  message(FATAL_ERROR "Objects are not placed in read-only data:\n  ${failures}")
+endif()
+
+message(STATUS "${objects} objects are placed in read-only data")
@@ -0,0 +1,150 @@
+/**
+ * \file optional.codegen.cpp
+ *
+ * \brief Code generation and ABI probes for #bpstd::optional and
+ *        #bpstd::compact_optional
+ *
+ * This translation unit is compiled with optimizations and is never linked.
+ * The static assertions check the layout and type properties that allow
+ * optionals to be passed in registers; the probe functions are
+ * disassembled by check_codegen.cmake, which requires that they contain no
+ * calls and no stack accesses. Probes named \c probe_branchless_* must
+ * additionally contain no conditional branches, and objects named
+ * \c rodata_* must be placed in read-only data.
+ */
+
+#include <bpstd/optional.hpp>
+#include <bpstd/compact_optional.hpp>
+
+#include <type_traits>
+
+//----------------------------------------------------------------------------
+// Layout
+//----------------------------------------------------------------------------
+
+static_assert( sizeof(bpstd::optional<int>) == 2 * sizeof(int),
+               "optional<int> must only add a flag and padding" );
+static_assert( alignof(bpstd::optional<int>) == alignof(int),
+               "optional<int> must have the alignment of int" );
+static_assert( sizeof(bpstd::optional<double>) == 2 * sizeof(double),
+               "optional<double> must only add a flag and padding" );
+static_assert( alignof(bpstd::optional<double>) == alignof(double),
+               "optional<double> must have the alignment of double" );
+// A null pointer is an engaged optional<T*>, so it cannot be the empty state
+static_assert( sizeof(bpstd::optional<int*>) == 2 * sizeof(int*),
+               "optional<T*> must only add a flag and padding" );
+static_assert( sizeof(bpstd::compact_optional<int*>) == sizeof(int*),
+               "compact_optional<T*> must use null as the empty state" );
+static_assert( sizeof(bpstd::optional<char>) == 2,
+               "optional<char> must only add a flag" );
+
+//----------------------------------------------------------------------------
+// Type Properties
+//----------------------------------------------------------------------------
+
+static_assert( std::is_trivially_copyable<bpstd::optional<int>>::value,
+               "optional<int> must be trivially copyable" );
+static_assert( std::is_trivially_copyable<bpstd::optional<double>>::value,
+               "optional<double> must be trivially copyable" );
+static_assert( std::is_trivially_copyable<bpstd::optional<int*>>::value,
+               "optional<T*> must be trivially copyable" );
+static_assert( std::is_trivially_destructible<bpstd::optional<int>>::value,
+               "optional<int> must be trivially destructible" );
+static_assert( std::is_trivially_destructible<bpstd::optional<int*>>::value,
+               "optional<T*> must be trivially destructible" );
+static_assert( std::is_standard_layout<bpstd::optional<int>>::value,
+               "optional<int> must be standard layout" );
+static_assert( std::is_standard_layout<bpstd::optional<double>>::value,
+               "optional<double> must be standard layout" );
+static_assert( std::is_standard_layout<bpstd::optional<int*>>::value,
+               "optional<T*> must be standard layout" );
+static_assert( std::is_standard_layout<bpstd::optional<bool>>::value,
+               "optional<bool> must be standard layout" );
+
+static_assert( static_cast<bool>(bpstd::optional<int>(42)),
+               "optional<int> must be engaged in a constant expression" );
+
+//----------------------------------------------------------------------------
+// Read-only Data
+//----------------------------------------------------------------------------
+
+namespace codegen {
+
+  extern const bpstd::optional<int> rodata_optional_int_table[4];
+  extern const bpstd::optional<double> rodata_optional_double;
+
+  // Constant-initialized optionals must not need a dynamic initializer or
+  // any writable state, so that they can be placed in read-only memory
+  const bpstd::optional<int> rodata_optional_int_table[4] = {
+    1, bpstd::nullopt, 3, bpstd::nullopt
+  };
+  const bpstd::optional<double> rodata_optional_double = 3.14;
+
+} // namespace codegen
+
+//----------------------------------------------------------------------------
+// Probes
+//----------------------------------------------------------------------------
+
+namespace codegen {
+
+  bpstd::optional<int> probe_return_optional_int( int value )
+  {
+    return value;
+  }
+
+  bpstd::optional<int> probe_return_empty_optional_int()
+  {
+    return bpstd::nullopt;
+  }
+
+  bool probe_has_value_int( bpstd::optional<int> optional )
+  {
+    return static_cast<bool>(optional);
+  }
+
+  double probe_value_or_double( const bpstd::optional<double>& optional,
+                                double default_value )
+  {
+    return optional.value_or(default_value);
+  }
+
+  bpstd::optional<int*> probe_copy_optional_pointer( const bpstd::optional<int*>& optional )
+  {
+    return optional;
+  }
+
+  void probe_assign_optional_pointer( bpstd::optional<int*>& lhs,
+                                      const bpstd::optional<int*>& rhs )
+  {
+    lhs = rhs;
+  }
+
+  int probe_branchless_unchecked_value_int( const bpstd::optional<int>& optional )
+  {
+    return optional.unchecked_value();
+  }
+
+  void probe_branchless_swap_int( bpstd::optional<int>& lhs,
+                                 bpstd::optional<int>& rhs )
+  {
+    swap(lhs,rhs);
+  }
+
+  void probe_branchless_reset_int( bpstd::optional<int>& optional )
+  {
+    optional.reset();
+  }
+
+  void probe_branchless_assign_nullopt_double( bpstd::optional<double>& optional )
+  {
+    optional = bpstd::nullopt;
+  }
+
+  double probe_branchless_value_or_compact_double( const bpstd::compact_optional<double>& optional,
+                                                   double default_value )
+  {
+    return optional.value_or(default_value);
+  }
+
+} // namespace codegen
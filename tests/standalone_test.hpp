@@ -0,0 +1,90 @@
+/**
+ * \file standalone_test.hpp
+ *
+ * \brief A minimal test harness for the tests that cannot run under Catch
+ *
+ * This is used by the executables that are built without exceptions, and by
+ * the checks that are expected to abort the process. Each \c CHECK reports
+ * its own failure, and #standalone_test::result gives the exit status.
+ */
+
+#ifndef BPSTD_TESTS_STANDALONE_TEST_HPP
+#define BPSTD_TESTS_STANDALONE_TEST_HPP
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+
+/// \brief Exits the process successfully; installed as a \c SIGABRT handler
+extern "C" inline void standalone_test_exit_on_abort( int )
+{
+  std::_Exit( EXIT_SUCCESS );
+}
+
+namespace standalone_test {
+
+  /// \brief Gets the number of checks that have failed so far
+  ///
+  /// \return a reference to the failure count
+  inline int& failures()
+    noexcept
+  {
+    static auto s_failures = 0;
+    return s_failures;
+  }
+
+  /// \brief Reports a failure if \p condition is \c false
+  ///
+  /// \param condition the result of the check
+  /// \param expression the text of the check
+  /// \param file the file containing the check
+  /// \param line the line of the check
+  inline void check( bool condition,
+                     const char* expression,
+                     const char* file,
+                     int line )
+  {
+    if(!condition) {
+      std::printf( "%s:%d: FAILED: %s\n", file, line, expression );
+      ++failures();
+    }
+  }
+
+  /// \brief Expects the process to abort before the test returns
+  ///
+  /// Once this is called, a \c SIGABRT exits the process successfully.
+  inline void expect_abort()
+  {
+    std::signal( SIGABRT, &standalone_test_exit_on_abort );
+  }
+
+  /// \brief Reports that an operation expected to abort did not
+  ///
+  /// \param operation the operation that was expected to abort
+  /// \param file the file containing the test
+  /// \param line the line of the test
+  /// \return \c EXIT_FAILURE
+  inline int did_not_abort( const char* operation, const char* file, int line )
+  {
+    std::printf( "%s:%d: FAILED: %s did not abort\n", file, line, operation );
+    return EXIT_FAILURE;
+  }
+
+  /// \brief Reports the outcome of the checks run so far
+  ///
+  /// \return \c EXIT_SUCCESS if no check failed, \c EXIT_FAILURE otherwise
+  inline int result()
+  {
+    if(failures() == 0) {
+      std::printf( "All tests passed\n" );
+      return EXIT_SUCCESS;
+    }
+    return EXIT_FAILURE;
+  }
+
+} // namespace standalone_test
+
+#define CHECK(expression) \
+  ::standalone_test::check( (expression), #expression, __FILE__, __LINE__ )
+
+#endif /* BPSTD_TESTS_STANDALONE_TEST_HPP */